@@ -0,0 +1,88 @@
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Graphics.hpp>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+
+////////////////////////////////////////////////////////////
+/// Build a line of a fake log
+///
+/// \param index Index of the line
+///
+/// \return Text of the line
+///
+////////////////////////////////////////////////////////////
+std::string makeLine(unsigned int index)
+{
+    std::ostringstream line;
+    line << "[" << std::setw(5) << index << "] the quick brown fox jumps over the lazy dog\n";
+    return line.str();
+}
+
+
+////////////////////////////////////////////////////////////
+/// Entry point of application
+///
+/// \return Application exit code
+///
+////////////////////////////////////////////////////////////
+int main()
+{
+    const unsigned int initialLength = 10000;
+    const unsigned int appendCount   = 500;
+
+    // Load the font used by the text
+    sf::Font font;
+    if (!font.loadFromFile("resources/sansation.ttf"))
+        return EXIT_FAILURE;
+
+    // Fill a text with about 10000 characters of log lines
+    std::string log;
+    unsigned int lineCount = 0;
+    while (log.size() < initialLength)
+        log += makeLine(lineCount++);
+
+    sf::Text text(log, font, 14);
+    std::cout << "Initial text: " << log.size() << " characters" << std::endl;
+
+    // Append lines one at a time: only the new characters are laid out
+    std::string appended = log;
+    sf::Clock clock;
+    for (unsigned int i = 0; i < appendCount; ++i)
+    {
+        appended += makeLine(lineCount + i);
+        text.setString(appended);
+    }
+    sf::Time appendTime = clock.getElapsedTime();
+
+    // Do the same, but with strings that don't extend the current one:
+    // the first character changes, so the whole text is laid out again
+    std::string rebuilt = log;
+    text.setString(rebuilt);
+    clock.restart();
+    for (unsigned int i = 0; i < appendCount; ++i)
+    {
+        rebuilt += makeLine(lineCount + i);
+        rebuilt[0] = (i % 2) ? '[' : '(';
+        text.setString(rebuilt);
+    }
+    sf::Time rebuildTime = clock.getElapsedTime();
+
+    // Display the results
+    std::cout << "Final text: " << appended.size() << " characters" << std::endl;
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << appendCount << " appends  : " << appendTime.asMicroseconds() / 1000.f  << " ms ("
+              << static_cast<float>(appendTime.asMicroseconds()) / appendCount << " us per update)" << std::endl;
+    std::cout << appendCount << " rebuilds : " << rebuildTime.asMicroseconds() / 1000.f << " ms ("
+              << static_cast<float>(rebuildTime.asMicroseconds()) / appendCount << " us per update)" << std::endl;
+
+    // Wait until the user presses 'enter' key
+    std::cout << "Press enter to exit..." << std::endl;
+    std::cin.ignore(10000, '\n');
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,139 @@
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Graphics.hpp>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+
+////////////////////////////////////////////////////////////
+/// Print the timings of a per-element loop and of a bulk call
+///
+/// \param name      Name of the test
+/// \param count     Number of elements transformed by the test
+/// \param loopTime  Time spent in the per-element loop
+/// \param bulkTime  Time spent in the bulk call
+///
+////////////////////////////////////////////////////////////
+void printResult(const char* name, std::size_t count, sf::Time loopTime, sf::Time bulkTime)
+{
+    float loop = loopTime.asMicroseconds() * 1000.f / count;
+    float bulk = bulkTime.asMicroseconds() * 1000.f / count;
+
+    std::cout << std::setw(24) << std::left << name << std::fixed << std::setprecision(2)
+              << "transformPoint: " << loop << " ns   "
+              << "transformPoints: " << bulk << " ns   "
+              << "(x" << loop / bulk << ")" << std::endl;
+}
+
+
+////////////////////////////////////////////////////////////
+/// Time the transformation of an array of points
+///
+/// \param transform Transform to apply
+/// \param size      Number of points in the array
+/// \param passes    Number of times the array is transformed
+///
+////////////////////////////////////////////////////////////
+void benchmarkPoints(const sf::Transform& transform, std::size_t size, unsigned int passes)
+{
+    std::vector<sf::Vector2f> points(size);
+    std::vector<sf::Vector2f> result(size);
+    for (std::size_t i = 0; i < size; ++i)
+        points[i] = sf::Vector2f(static_cast<float>(i % 640), static_cast<float>(i / 640));
+
+    // One point at a time
+    sf::Clock clock;
+    for (unsigned int pass = 0; pass < passes; ++pass)
+        for (std::size_t i = 0; i < size; ++i)
+            result[i] = transform.transformPoint(points[i]);
+    sf::Time loopTime = clock.getElapsedTime();
+    float check = result[size - 1].x;
+
+    // Whole array at once
+    clock.restart();
+    for (unsigned int pass = 0; pass < passes; ++pass)
+        transform.transformPoints(&points[0], &result[0], size);
+    sf::Time bulkTime = clock.getElapsedTime();
+
+    // Make sure that both versions compute the same thing
+    if (result[size - 1].x != check)
+        std::cout << "Results differ!" << std::endl;
+
+    std::ostringstream name;
+    name << "Vector2f x " << size;
+    printResult(name.str().c_str(), size * passes, loopTime, bulkTime);
+}
+
+
+////////////////////////////////////////////////////////////
+/// Time the transformation of an array of vertices
+///
+/// \param transform Transform to apply
+/// \param size      Number of vertices in the array
+/// \param passes    Number of times the array is transformed
+///
+////////////////////////////////////////////////////////////
+void benchmarkVertices(const sf::Transform& transform, std::size_t size, unsigned int passes)
+{
+    std::vector<sf::Vertex> vertices(size);
+    std::vector<sf::Vertex> result(size);
+    for (std::size_t i = 0; i < size; ++i)
+        vertices[i] = sf::Vertex(sf::Vector2f(static_cast<float>(i % 640), static_cast<float>(i / 640)), sf::Color::White);
+
+    // One vertex at a time
+    sf::Clock clock;
+    for (unsigned int pass = 0; pass < passes; ++pass)
+    {
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            result[i] = vertices[i];
+            result[i].position = transform.transformPoint(vertices[i].position);
+        }
+    }
+    sf::Time loopTime = clock.getElapsedTime();
+    float check = result[size - 1].position.x;
+
+    // Whole array at once
+    clock.restart();
+    for (unsigned int pass = 0; pass < passes; ++pass)
+        transform.transformPoints(&vertices[0], &result[0], size);
+    sf::Time bulkTime = clock.getElapsedTime();
+
+    // Make sure that both versions compute the same thing
+    if (result[size - 1].position.x != check)
+        std::cout << "Results differ!" << std::endl;
+
+    std::ostringstream name;
+    name << "Vertex x " << size;
+    printResult(name.str().c_str(), size * passes, loopTime, bulkTime);
+}
+
+
+////////////////////////////////////////////////////////////
+/// Entry point of application
+///
+/// \return Application exit code
+///
+////////////////////////////////////////////////////////////
+int main()
+{
+    // A typical sprite transform
+    sf::Transform transform;
+    transform.translate(400, 300).rotate(30).scale(2, 0.5f);
+
+    // Small arrays stay in the cache, large ones are limited by the memory bandwidth
+    benchmarkPoints(transform, 1024, 20000);
+    benchmarkPoints(transform, 100000, 200);
+    benchmarkVertices(transform, 1024, 20000);
+    benchmarkVertices(transform, 100000, 200);
+
+    // Wait until the user presses 'enter' key
+    std::cout << "Press enter to exit..." << std::endl;
+    std::cin.ignore(10000, '\n');
+
+    return EXIT_SUCCESS;
+}
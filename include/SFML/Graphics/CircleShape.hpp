@@ -103,6 +103,18 @@ public :
     ////////////////////////////////////////////////////////////
     virtual Vector2f getPoint(unsigned int index) const;
 
+protected :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the parameters that define the points of the shape
+    ///
+    /// \param parameters Receives the radius of the circle
+    ///
+    /// \return Always true, identical circles share their geometry
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual bool getGeometryParameters(Vector2f& parameters) const;
+
 private :
 
     ////////////////////////////////////////////////////////////
@@ -31,6 +31,7 @@
 #include <SFML/Graphics/Export.hpp>
 #include <SFML/Graphics/Glyph.hpp>
 #include <SFML/Graphics/Texture.hpp>
+#include <SFML/Graphics/TextLayout.hpp>
 #include <SFML/Graphics/Rect.hpp>
 #include <SFML/System/Vector2.hpp>
 #include <SFML/System/String.hpp>
@@ -41,7 +42,13 @@
 
 namespace sf
 {
+namespace priv
+{
+    class SkylinePacker;
+}
+
 class InputStream;
+class Shader;
 
 ////////////////////////////////////////////////////////////
 /// \brief Class for loading and manipulating character fonts
@@ -142,6 +149,51 @@ public :
     ////////////////////////////////////////////////////////////
     const Glyph& getGlyph(Uint32 codePoint, unsigned int characterSize, bool bold) const;
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Load a set of glyphs in advance
+    ///
+    /// Glyphs are normally loaded the first time they are
+    /// requested, which can cause hitches when a lot of new
+    /// text appears at once. This function loads the glyphs of
+    /// all the characters of \a characters, so that they are
+    /// ready when they are needed. The glyphs are rasterized
+    /// in parallel by several threads, then added to the font
+    /// all at once.
+    ///
+    /// Fonts loaded from a stream can't be read by several
+    /// threads; their glyphs are loaded in the calling thread.
+    ///
+    /// \param characters    Characters whose glyphs must be loaded
+    /// \param characterSize Reference character size
+    /// \param bold          Load the bold version or the regular one?
+    ///
+    /// \see preloadAsync
+    ///
+    ////////////////////////////////////////////////////////////
+    void preload(const String& characters, unsigned int characterSize, bool bold = false) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Load a set of glyphs in advance, in the background
+    ///
+    /// This function is similar to preload, except that it returns
+    /// immediately: the glyphs are rasterized by background threads,
+    /// and added to the font by the first call to getGlyph, getTexture
+    /// or preload that happens after they are all ready. Glyphs that
+    /// are requested before are loaded as usual.
+    ///
+    /// Fonts loaded from a stream can't be read by several
+    /// threads; their glyphs are loaded in the calling thread,
+    /// before this function returns.
+    ///
+    /// \param characters    Characters whose glyphs must be loaded
+    /// \param characterSize Reference character size
+    /// \param bold          Load the bold version or the regular one?
+    ///
+    /// \see preload
+    ///
+    ////////////////////////////////////////////////////////////
+    void preloadAsync(const String& characters, unsigned int characterSize, bool bold = false) const;
+
     ////////////////////////////////////////////////////////////
     /// \brief Get the kerning offset of two glyphs
     ///
@@ -173,6 +225,26 @@ public :
     ////////////////////////////////////////////////////////////
     int getLineSpacing(unsigned int characterSize) const;
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the layout of a string
+    ///
+    /// This function measures a string without building any
+    /// geometry: see sf::TextLayout. Layouts are cached by
+    /// string and parameters, so measuring the same string
+    /// several times is cheap.
+    /// The layout is returned by copy, so it remains valid
+    /// whatever happens to the cache or to the font.
+    ///
+    /// \param string        String to lay out
+    /// \param characterSize Reference character size
+    /// \param bold          Use the metrics of the bold glyphs?
+    /// \param maxWidth      Maximum width of the lines, or 0 to disable line wrapping
+    ///
+    /// \return Layout of the string
+    ///
+    ////////////////////////////////////////////////////////////
+    TextLayout getLayout(const String& string, unsigned int characterSize, bool bold = false, float maxWidth = 0.f) const;
+
     ////////////////////////////////////////////////////////////
     /// \brief Retrieve the texture containing the loaded glyphs of a certain size
     ///
@@ -180,6 +252,9 @@ public :
     /// are requested, thus it is not very relevant. It is mainly
     /// used internally by sf::Text.
     ///
+    /// The glyphs loaded since the last call are written to the
+    /// texture by this function, all at once.
+    ///
     /// \param characterSize Reference character size
     ///
     /// \return Texture containing the glyphs of the requested size
@@ -188,29 +263,84 @@ public :
     const Texture& getTexture(unsigned int characterSize) const;
 
     ////////////////////////////////////////////////////////////
-    /// \brief Overload of assignment operator
+    /// \brief Get the fraction of a glyph texture occupied by glyphs
     ///
-    /// \param right Instance to assign
+    /// Glyph textures start small and are enlarged when they
+    /// are full. A fill ratio that stays low after the glyphs
+    /// of an application have been loaded means that space
+    /// is wasted; a high one that the texture will soon have
+    /// to be enlarged again.
     ///
-    /// \return Reference to self
+    /// \param characterSize Reference character size
+    ///
+    /// \return Fill ratio of the texture of the requested size, in range [0, 1]
     ///
     ////////////////////////////////////////////////////////////
-    Font& operator =(const Font& right);
+    float getFillRatio(unsigned int characterSize) const;
 
-private :
+    ////////////////////////////////////////////////////////////
+    /// \brief Enable or disable the distance field mode
+    ///
+    /// In distance field mode, the glyphs are rasterized only once,
+    /// at a fixed reference size, as distance fields: each pixel
+    /// stores its distance to the outline of the glyph rather than
+    /// its coverage. All the character sizes then share a single
+    /// texture, and the glyphs are scaled when they are drawn;
+    /// they remain sharp at any size or scale, at the cost of
+    /// slightly rounder corners.
+    ///
+    /// Drawing distance fields requires a shader, which is provided
+    /// by getShader and automatically used by sf::Text. If shaders
+    /// are not supported, the glyphs are drawn with blurry edges.
+    ///
+    /// Changing the mode discards all the loaded glyphs: the texts
+    /// that use the font must be updated (by setting their font
+    /// again, for example).
+    /// The distance field mode is disabled by default.
+    ///
+    /// \param distanceField True to enable the distance field mode, false to disable it
+    ///
+    /// \see isDistanceField, getShader
+    ///
+    ////////////////////////////////////////////////////////////
+    void setDistanceField(bool distanceField);
 
     ////////////////////////////////////////////////////////////
-    /// \brief Structure defining a row of glyphs
+    /// \brief Tell whether the distance field mode is enabled or not
+    ///
+    /// \return True if the distance field mode is enabled
+    ///
+    /// \see setDistanceField
     ///
     ////////////////////////////////////////////////////////////
-    struct Row
-    {
-        Row(unsigned int rowTop, unsigned int rowHeight) : width(0), top(rowTop), height(rowHeight) {}
+    bool isDistanceField() const;
 
-        unsigned int width;  ///< Current width of the row
-        unsigned int top;    ///< Y position of the row into the texture
-        unsigned int height; ///< Height of the row
-    };
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the shader that must be used to draw the glyphs
+    ///
+    /// Glyphs of the distance field mode can't be drawn directly,
+    /// they need this shader to turn the distances back into
+    /// sharp edges. It uses the color of the vertices like the
+    /// default rendering.
+    ///
+    /// \return Shader to use, or NULL if the glyphs can be drawn without shader
+    ///
+    /// \see setDistanceField
+    ///
+    ////////////////////////////////////////////////////////////
+    const Shader* getShader() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Overload of assignment operator
+    ///
+    /// \param right Instance to assign
+    ///
+    /// \return Reference to self
+    ///
+    ////////////////////////////////////////////////////////////
+    Font& operator =(const Font& right);
+
+private :
 
     ////////////////////////////////////////////////////////////
     // Types
@@ -224,13 +354,46 @@ private :
     struct Page
     {
         Page();
-
-        GlyphTable       glyphs;  ///< Table mapping code points to their corresponding glyph
-        sf::Texture      texture; ///< Texture containing the pixels of the glyphs
-        unsigned int     nextRow; ///< Y position of the next new row in the texture
-        std::vector<Row> rows;    ///< List containing the position of all the existing rows
+        Page(const Page& copy);
+        ~Page();
+        Page& operator =(const Page& right);
+
+        GlyphTable           glyphs;      ///< Table mapping code points to their corresponding glyph
+        sf::Texture          texture;     ///< Texture containing the pixels of the glyphs
+        priv::SkylinePacker* packer;      ///< Free space of the texture
+        std::vector<Uint8>   pixels;      ///< Copy of the texture pixels, where new glyphs are written before being uploaded
+        unsigned int         dirtyTop;    ///< First row of pixels not uploaded to the texture yet
+        unsigned int         dirtyBottom; ///< Row following the last row of pixels not uploaded to the texture yet
     };
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Rasterized glyph, not added to a page yet
+    ///        (defined in the implementation)
+    ///
+    ////////////////////////////////////////////////////////////
+    struct GlyphBitmap;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Set of glyphs rasterized by worker threads
+    ///        (defined in the implementation)
+    ///
+    ////////////////////////////////////////////////////////////
+    struct Preload;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Fast lookup tables for the glyphs, kerning and line
+    ///        spacing of a character size (defined in the implementation)
+    ///
+    ////////////////////////////////////////////////////////////
+    struct SizeCache;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Layout of a string, with the parameters that produced
+    ///        it (defined in the implementation)
+    ///
+    ////////////////////////////////////////////////////////////
+    struct CachedLayout;
+
     ////////////////////////////////////////////////////////////
     /// \brief Free all the internal resources
     ///
@@ -249,6 +412,111 @@ private :
     ////////////////////////////////////////////////////////////
     Glyph loadGlyph(Uint32 codePoint, unsigned int characterSize, bool bold) const;
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Rasterize a glyph
+    ///
+    /// This function only uses the given FreeType objects, so
+    /// it can be called by several threads at the same time as
+    /// long as each one has its own library and face.
+    ///
+    /// \param library   FreeType library (typeless)
+    /// \param face      FreeType face, whose size is already set (typeless)
+    /// \param codePoint Unicode code point of the character to rasterize
+    /// \param bold      Rasterize the bold version or the regular one?
+    /// \param bitmap    Receives the rasterized glyph
+    ///
+    /// \return True on success, false if the glyph couldn't be loaded
+    ///
+    ////////////////////////////////////////////////////////////
+    static bool rasterizeGlyph(void* library, void* face, Uint32 codePoint, bool bold, GlyphBitmap& bitmap);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Convert a rasterized glyph to a distance field
+    ///
+    /// The bitmap is enlarged so that the distances can spread
+    /// around the glyph.
+    ///
+    /// \param bitmap Glyph to convert
+    ///
+    ////////////////////////////////////////////////////////////
+    static void makeDistanceField(GlyphBitmap& bitmap);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the page that stores the glyphs of a character size
+    ///
+    /// In distance field mode, all the sizes share the same page.
+    ///
+    /// \param characterSize Reference character size
+    ///
+    /// \return Page of the glyphs
+    ///
+    ////////////////////////////////////////////////////////////
+    Page& getPage(unsigned int characterSize) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the lookup tables of a character size
+    ///
+    /// The tables of the last requested size are remembered,
+    /// so that consecutive calls for the same size are fast.
+    ///
+    /// \param characterSize Reference character size
+    ///
+    /// \return Lookup tables of the character size
+    ///
+    ////////////////////////////////////////////////////////////
+    SizeCache& getSizeCache(unsigned int characterSize) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Destroy the lookup tables of all the character sizes
+    ///
+    ////////////////////////////////////////////////////////////
+    void clearSizeCaches() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Destroy the cached layouts
+    ///
+    ////////////////////////////////////////////////////////////
+    void clearLayouts() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Add a rasterized glyph to a page
+    ///
+    /// \param page   Page of glyphs to add the glyph to
+    /// \param bitmap Rasterized glyph
+    ///
+    /// \return The glyph, with its texture rectangle in the page
+    ///
+    ////////////////////////////////////////////////////////////
+    Glyph addGlyph(Page& page, const GlyphBitmap& bitmap) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Add the glyphs of the finished background preloads to their page
+    ///
+    /// \param wait Wait for the unfinished preloads?
+    ///
+    ////////////////////////////////////////////////////////////
+    void commitPreloads(bool wait) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Create a preload for the glyphs of a string that are not loaded yet
+    ///
+    /// \param characters    Characters whose glyphs must be loaded
+    /// \param characterSize Reference character size
+    /// \param bold          Load the bold version or the regular one?
+    ///
+    /// \return New preload, or NULL if there's nothing to load
+    ///
+    ////////////////////////////////////////////////////////////
+    Preload* createPreload(const String& characters, unsigned int characterSize, bool bold) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Add the glyphs of a finished preload to their page
+    ///
+    /// \param preload Preload to commit
+    ///
+    ////////////////////////////////////////////////////////////
+    void commitPreload(Preload& preload) const;
+
     ////////////////////////////////////////////////////////////
     /// \brief Find a suitable rectangle within the texture for a glyph
     ///
@@ -261,6 +529,14 @@ private :
     ////////////////////////////////////////////////////////////
     IntRect findGlyphRect(Page& page, unsigned int width, unsigned int height) const;
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Upload the pixels of the new glyphs of a page to its texture
+    ///
+    /// \param page Page of glyphs to update
+    ///
+    ////////////////////////////////////////////////////////////
+    void uploadPage(Page& page) const;
+
     ////////////////////////////////////////////////////////////
     /// \brief Make sure that the given size is the current one
     ///
@@ -274,17 +550,29 @@ private :
     ////////////////////////////////////////////////////////////
     // Types
     ////////////////////////////////////////////////////////////
-    typedef std::map<unsigned int, Page> PageTable; ///< Table mapping a character size to its page (texture)
+    typedef std::map<unsigned int, Page>       PageTable;       ///< Table mapping a character size to its page (texture)
+    typedef std::map<unsigned int, GlyphTable> GlyphTableTable; ///< Table mapping a character size to its glyphs
+    typedef std::map<unsigned int, SizeCache*> SizeCacheTable;  ///< Table mapping a character size to its lookup tables
+    typedef std::map<Uint64, CachedLayout*>    LayoutTable;     ///< Table mapping a hash of a string and its parameters to its layout
 
     ////////////////////////////////////////////////////////////
     // Member data
     ////////////////////////////////////////////////////////////
-    void*                      m_library;     ///< Pointer to the internal library interface (it is typeless to avoid exposing implementation details)
-    void*                      m_face;        ///< Pointer to the internal font face (it is typeless to avoid exposing implementation details)
-    void*                      m_streamRec;   ///< Pointer to the stream rec instance (it is typeless to avoid exposing implementation details)
-    int*                       m_refCount;    ///< Reference counter used by implicit sharing
-    mutable PageTable          m_pages;       ///< Table containing the glyphs pages by character size
-    mutable std::vector<Uint8> m_pixelBuffer; ///< Pixel buffer holding a glyph's pixels before being written to the texture
+    void*                         m_library;       ///< Pointer to the internal library interface (it is typeless to avoid exposing implementation details)
+    void*                         m_face;          ///< Pointer to the internal font face (it is typeless to avoid exposing implementation details)
+    void*                         m_streamRec;     ///< Pointer to the stream rec instance (it is typeless to avoid exposing implementation details)
+    int*                          m_refCount;      ///< Reference counter used by implicit sharing
+    mutable PageTable             m_pages;         ///< Table containing the glyphs pages by character size
+    std::string                   m_fileName;      ///< Path of the font file, if the font was loaded from a file
+    const void*                   m_fileData;      ///< Contents of the font file, if the font was loaded from memory
+    std::size_t                   m_fileSize;      ///< Size of the font file, if the font was loaded from memory
+    mutable std::vector<Preload*> m_preloads;      ///< Preloads running in the background
+    bool                          m_distanceField; ///< Are the glyphs rasterized as distance fields?
+    mutable GlyphTableTable       m_scaledGlyphs;  ///< Distance field glyphs, scaled to each character size
+    mutable SizeCacheTable        m_sizeCaches;    ///< Lookup tables of the character sizes
+    mutable unsigned int          m_lastSize;      ///< Character size of the last requested lookup tables
+    mutable SizeCache*            m_lastCache;     ///< Last requested lookup tables
+    mutable LayoutTable           m_layouts;       ///< Cached layouts of strings
 };
 
 } // namespace sf
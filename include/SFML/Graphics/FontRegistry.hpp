@@ -0,0 +1,193 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2012 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+#ifndef SFML_FONTREGISTRY_HPP
+#define SFML_FONTREGISTRY_HPP
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Graphics/Export.hpp>
+#include <SFML/System/NonCopyable.hpp>
+#include <SFML/Config.hpp>
+#include <map>
+#include <string>
+
+
+namespace sf
+{
+class Font;
+
+////////////////////////////////////////////////////////////
+/// \brief Shares the fonts loaded several times from the same source
+///
+////////////////////////////////////////////////////////////
+class SFML_GRAPHICS_API FontRegistry : NonCopyable
+{
+public :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Default constructor
+    ///
+    /// Creates an empty registry.
+    ///
+    ////////////////////////////////////////////////////////////
+    FontRegistry();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Destructor
+    ///
+    /// All the fonts of the registry are destroyed.
+    ///
+    ////////////////////////////////////////////////////////////
+    ~FontRegistry();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the font of a file, loading it if needed
+    ///
+    /// If a font was already loaded from the same path, it is
+    /// returned directly; otherwise a new font is loaded and
+    /// added to the registry.
+    ///
+    /// \param filename Path of the font file to load
+    ///
+    /// \return Pointer to the font, or NULL if it failed to load
+    ///
+    /// \see loadFromMemory
+    ///
+    ////////////////////////////////////////////////////////////
+    Font* loadFromFile(const std::string& filename);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the font of a file in memory, loading it if needed
+    ///
+    /// Fonts are identified by their contents: if a font was
+    /// already loaded from identical data, even at a different
+    /// address, it is returned directly; otherwise a new font is
+    /// loaded and added to the registry.
+    ///
+    /// Like sf::Font::loadFromMemory, this function doesn't copy
+    /// the data: it must remain valid as long as the font is in
+    /// the registry.
+    ///
+    /// \param data        Pointer to the file data in memory
+    /// \param sizeInBytes Size of the data to load, in bytes
+    ///
+    /// \return Pointer to the font, or NULL if it failed to load
+    ///
+    /// \see loadFromFile
+    ///
+    ////////////////////////////////////////////////////////////
+    Font* loadFromMemory(const void* data, std::size_t sizeInBytes);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Remove a font from the registry and destroy it
+    ///
+    /// This function does nothing if \a font doesn't belong
+    /// to the registry.
+    ///
+    /// \param font Font to remove
+    ///
+    ////////////////////////////////////////////////////////////
+    void remove(const Font* font);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Remove and destroy all the fonts of the registry
+    ///
+    ////////////////////////////////////////////////////////////
+    void clear();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the number of fonts in the registry
+    ///
+    /// \return Number of fonts
+    ///
+    ////////////////////////////////////////////////////////////
+    std::size_t getFontCount() const;
+
+private :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Font loaded from memory
+    ///
+    ////////////////////////////////////////////////////////////
+    struct MemoryFont
+    {
+        const void* data; ///< Contents of the font file
+        std::size_t size; ///< Size of the contents, in bytes
+        Font*       font; ///< Font loaded from the contents
+    };
+
+    ////////////////////////////////////////////////////////////
+    // Types
+    ////////////////////////////////////////////////////////////
+    typedef std::map<std::string, Font*>      FileTable;   ///< Fonts loaded from files, by path
+    typedef std::multimap<Uint64, MemoryFont> MemoryTable; ///< Fonts loaded from memory, by hash of their contents
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    FileTable   m_files;  ///< Fonts loaded from files
+    MemoryTable m_memory; ///< Fonts loaded from memory
+};
+
+} // namespace sf
+
+
+#endif // SFML_FONTREGISTRY_HPP
+
+
+////////////////////////////////////////////////////////////
+/// \class sf::FontRegistry
+/// \ingroup graphics
+///
+/// Loading the same font twice creates two independent
+/// sf::Font instances, each with its own FreeType face and
+/// its own glyph textures. When several parts of a program
+/// need the same fonts, they can share a sf::FontRegistry:
+/// it returns the same sf::Font every time a font is requested
+/// from the same file, or from identical data in memory, so
+/// that the face and the glyphs are loaded only once.
+///
+/// The fonts belong to the registry: they are destroyed
+/// with it, or when they are removed from it.
+///
+/// Example:
+/// \code
+/// sf::FontRegistry registry;
+///
+/// // In the menu
+/// sf::Font* font = registry.loadFromFile("arial.ttf");
+/// if (!font)
+///     return -1;
+/// sf::Text title("Menu", *font);
+///
+/// // In the game: the same font is returned, its glyphs are already loaded
+/// sf::Text score("0", *registry.loadFromFile("arial.ttf"));
+/// \endcode
+///
+/// \see sf::Font
+///
+////////////////////////////////////////////////////////////
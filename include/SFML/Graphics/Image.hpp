@@ -254,6 +254,8 @@ public :
 
 private :
 
+    friend class ReadbackRequest;
+
     ////////////////////////////////////////////////////////////
     // Member data
     ////////////////////////////////////////////////////////////
@@ -0,0 +1,214 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2012 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+#ifndef SFML_INDEXARRAY_HPP
+#define SFML_INDEXARRAY_HPP
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Graphics/Export.hpp>
+#include <SFML/Config.hpp>
+#include <vector>
+
+
+namespace sf
+{
+////////////////////////////////////////////////////////////
+/// \brief Array of vertex indices for indexed drawing
+///
+////////////////////////////////////////////////////////////
+class SFML_GRAPHICS_API IndexArray
+{
+public :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Size of the indices stored in the array
+    ///
+    ////////////////////////////////////////////////////////////
+    enum Type
+    {
+        Index16, ///< Indices are 16 bits unsigned integers
+        Index32  ///< Indices are 32 bits unsigned integers
+    };
+
+public :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Default constructor
+    ///
+    /// Creates an empty array of 16 bits indices.
+    ///
+    ////////////////////////////////////////////////////////////
+    IndexArray();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Construct the index array with a type and an initial number of indices
+    ///
+    /// \param type       Size of the indices
+    /// \param indexCount Initial number of indices in the array
+    ///
+    ////////////////////////////////////////////////////////////
+    explicit IndexArray(Type type, unsigned int indexCount = 0);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Return the index count
+    ///
+    /// \return Number of indices in the array
+    ///
+    ////////////////////////////////////////////////////////////
+    unsigned int getIndexCount() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Return the size of the indices stored in the array
+    ///
+    /// \return Type of the indices
+    ///
+    ////////////////////////////////////////////////////////////
+    Type getType() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the value of an index
+    ///
+    /// This function doesn't check \a position, it must be in range
+    /// [0, getIndexCount() - 1]. The behaviour is undefined
+    /// otherwise.
+    ///
+    /// \param position Position of the index to get
+    ///
+    /// \return Value of the index at \a position
+    ///
+    ////////////////////////////////////////////////////////////
+    Uint32 operator [](unsigned int position) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Change the value of an index
+    ///
+    /// This function doesn't check \a position, it must be in range
+    /// [0, getIndexCount() - 1]. The behaviour is undefined
+    /// otherwise.
+    /// If \a value doesn't fit in 16 bits, a 16 bits array is
+    /// converted to a 32 bits array.
+    ///
+    /// \param position Position of the index to change
+    /// \param value    New value of the index
+    ///
+    ////////////////////////////////////////////////////////////
+    void setIndex(unsigned int position, Uint32 value);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Clear the index array
+    ///
+    /// This function removes all the indices from the array.
+    /// It doesn't deallocate the corresponding memory.
+    ///
+    ////////////////////////////////////////////////////////////
+    void clear();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Resize the index array
+    ///
+    /// If \a indexCount is greater than the current size, the previous
+    /// indices are kept and new zero indices are added.
+    /// If \a indexCount is less than the current size, existing indices
+    /// are removed from the array.
+    ///
+    /// \param indexCount New size of the array (number of indices)
+    ///
+    ////////////////////////////////////////////////////////////
+    void resize(unsigned int indexCount);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Add an index to the array
+    ///
+    /// If \a value doesn't fit in 16 bits, a 16 bits array is
+    /// converted to a 32 bits array.
+    ///
+    /// \param value Index to add
+    ///
+    ////////////////////////////////////////////////////////////
+    void append(Uint32 value);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get a read-only pointer to the array of indices
+    ///
+    /// The returned pointer points to 16 or 32 bits integers
+    /// depending on getType(). It may become invalid after the
+    /// array is modified.
+    ///
+    /// \return Pointer to the indices, or NULL if the array is empty
+    ///
+    ////////////////////////////////////////////////////////////
+    const void* getData() const;
+
+private :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Convert the array to 32 bits indices
+    ///
+    ////////////////////////////////////////////////////////////
+    void promote();
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    Type                m_type;      ///< Size of the indices
+    std::vector<Uint16> m_indices16; ///< Indices, if the array uses 16 bits indices
+    std::vector<Uint32> m_indices32; ///< Indices, if the array uses 32 bits indices
+};
+
+} // namespace sf
+
+
+#endif // SFML_INDEXARRAY_HPP
+
+
+////////////////////////////////////////////////////////////
+/// \class sf::IndexArray
+/// \ingroup graphics
+///
+/// sf::IndexArray stores the indices of the vertices that
+/// make the primitives of an indexed draw call. Using indices,
+/// vertices that are shared by several primitives (like the
+/// two triangles of a quad) need to be stored only once.
+///
+/// Indices are stored as 16 bits integers by default, which
+/// is enough to address 65536 vertices and saves bandwidth;
+/// the array is automatically converted to 32 bits indices
+/// when a bigger value is stored.
+///
+/// Example:
+/// \code
+/// sf::Vertex quad[4] = ...;
+///
+/// sf::IndexArray indices;
+/// indices.append(0); indices.append(1); indices.append(2);
+/// indices.append(0); indices.append(2); indices.append(3);
+///
+/// window.draw(quad, 4, indices, sf::Triangles);
+/// \endcode
+///
+/// \see sf::RenderTarget, sf::VertexArray
+///
+////////////////////////////////////////////////////////////
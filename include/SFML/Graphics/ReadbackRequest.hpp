@@ -0,0 +1,269 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2012 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+#ifndef SFML_READBACKREQUEST_HPP
+#define SFML_READBACKREQUEST_HPP
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Graphics/Export.hpp>
+#include <SFML/Window/GlResource.hpp>
+#include <SFML/System/NonCopyable.hpp>
+#include <SFML/System/Vector2.hpp>
+#include <vector>
+
+
+namespace sf
+{
+namespace priv
+{
+    class PixelBuffer;
+}
+
+class Image;
+class RenderWindow;
+class Texture;
+
+////////////////////////////////////////////////////////////
+/// \brief Asynchronous copy of pixels from the graphics card
+///        to the system memory
+///
+////////////////////////////////////////////////////////////
+class SFML_GRAPHICS_API ReadbackRequest : GlResource, NonCopyable
+{
+public :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Default constructor
+    ///
+    /// Creates an idle request.
+    ///
+    ////////////////////////////////////////////////////////////
+    ReadbackRequest();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Destructor
+    ///
+    ////////////////////////////////////////////////////////////
+    ~ReadbackRequest();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Start reading the pixels of a texture
+    ///
+    /// The pixels of the previous read, if any, are discarded.
+    /// This function returns immediately; the graphics card
+    /// copies the pixels while the program goes on.
+    ///
+    /// \param texture Texture to read
+    ///
+    /// \return True if the read was started
+    ///
+    ////////////////////////////////////////////////////////////
+    bool start(const Texture& texture);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Start reading the current contents of a window
+    ///
+    /// This function must be called before the window is
+    /// displayed, like RenderWindow::capture. The pixels of the
+    /// previous read, if any, are discarded. This function
+    /// returns immediately; the graphics card copies the pixels
+    /// while the program goes on.
+    ///
+    /// \param window Window to read
+    ///
+    /// \return True if the read was started
+    ///
+    ////////////////////////////////////////////////////////////
+    bool start(const RenderWindow& window);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Tell whether a read was started and not released yet
+    ///
+    /// \return True if the request holds (or will hold) pixels
+    ///
+    ////////////////////////////////////////////////////////////
+    bool isStarted() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Tell whether the pixels can be accessed without waiting
+    ///
+    /// This function never blocks. Reads usually complete one
+    /// or two frames after they were started. If the system
+    /// doesn't support fences, this function returns true as
+    /// soon as the read was started.
+    ///
+    /// \return True if the read is finished
+    ///
+    ////////////////////////////////////////////////////////////
+    bool isReady() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the size of the pixel area that was read
+    ///
+    /// \return Size of the area, in pixels
+    ///
+    ////////////////////////////////////////////////////////////
+    Vector2u getSize() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get a read-only pointer to the pixels
+    ///
+    /// The returned pointer points directly to the memory
+    /// that the graphics card wrote to, no copy is made. It
+    /// points to the first pixel of the top row; pixels are
+    /// 32-bits RGBA, and consecutive rows are getPitch() bytes
+    /// apart.
+    /// Textures that use the Texture::Alpha format are an
+    /// exception: their pixels are copied so that their color
+    /// components can be set to white, like Texture::copyToImage
+    /// does.
+    ///
+    /// If the read is not finished yet, this function waits for
+    /// it. The pointer remains valid until release() or start()
+    /// is called, or the request is destroyed.
+    ///
+    /// \return Pointer to the pixels, or NULL if no read was started
+    ///
+    ////////////////////////////////////////////////////////////
+    const Uint8* getPixels();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the distance between two consecutive rows of pixels
+    ///
+    /// The pitch is negative if the rows are stored from bottom
+    /// to top, which is the case when reading a window. It may
+    /// also be bigger than 4 * getSize().x, if the texture is
+    /// padded to a power of two size.
+    ///
+    /// \return Offset, in bytes, from the start of a row to the start of the next one
+    ///
+    ////////////////////////////////////////////////////////////
+    int getPitch() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Copy the pixels to an image
+    ///
+    /// This is a shortcut for getPixels() followed by a single
+    /// copy to \a image. Like getPixels, it waits for the read
+    /// to finish if needed.
+    ///
+    /// \param image Image to fill with the pixels
+    ///
+    /// \return True on success, false if no read was started
+    ///
+    ////////////////////////////////////////////////////////////
+    bool copyToImage(Image& image);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Release the pixels and make the request idle
+    ///
+    /// The pointer returned by getPixels becomes invalid.
+    ///
+    ////////////////////////////////////////////////////////////
+    void release();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Tell whether reads are really asynchronous on this system
+    ///
+    /// If this function returns false, reads are done synchronously
+    /// when they are started. The API can be used the same way.
+    ///
+    /// \return True if pixel buffer objects are supported
+    ///
+    ////////////////////////////////////////////////////////////
+    static bool isAvailable();
+
+private :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Prepare the storage of a new read
+    ///
+    /// \param size Size of the storage, in bytes
+    ///
+    /// \return True if the read can be done through a pixel buffer
+    ///
+    ////////////////////////////////////////////////////////////
+    bool prepare(std::size_t size);
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    priv::PixelBuffer* m_buffer;    ///< Pixel buffer that receives the pixels, if supported
+    std::vector<Uint8> m_fallback;  ///< Storage used when pixel buffers are not supported, or to fix the pixels of alpha textures
+    const Uint8*       m_mapped;    ///< Start of the storage, when it is accessible
+    Vector2u           m_size;      ///< Size of the area that was read
+    std::size_t        m_topRow;    ///< Offset of the top row in the storage, in bytes
+    int                m_pitch;     ///< Offset between consecutive rows, in bytes
+    bool               m_isAlpha;   ///< Was the read texture in the alpha format?
+    bool               m_isStarted; ///< Is there a read in progress or finished?
+};
+
+} // namespace sf
+
+
+#endif // SFML_READBACKREQUEST_HPP
+
+
+////////////////////////////////////////////////////////////
+/// \class sf::ReadbackRequest
+/// \ingroup graphics
+///
+/// Copying pixels from the graphics card (Texture::copyToImage,
+/// RenderWindow::capture) blocks the program until the graphics
+/// card has rendered everything and transferred the pixels.
+/// sf::ReadbackRequest splits the operation in two: start()
+/// asks the graphics card to write the pixels to a buffer,
+/// and returns immediately; the pixels are retrieved later,
+/// when isReady() returns true.
+///
+/// Using a few requests in turn, the pixels of every frame can
+/// be read without ever waiting, which is what video capture
+/// needs. getPixels gives a direct access to the buffer, for
+/// example to feed an encoder without any intermediate copy.
+///
+/// Example:
+/// \code
+/// sf::ReadbackRequest requests[3];
+/// unsigned int frame = 0;
+///
+/// while (window.isOpen())
+/// {
+///     ... // draw the scene
+///
+///     // Retrieve the frame captured three frames ago, and capture this one
+///     sf::ReadbackRequest& request = requests[frame++ % 3];
+///     if (request.isStarted())
+///         encoder.write(request.getPixels(), request.getSize(), request.getPitch());
+///     request.start(window);
+///
+///     window.display();
+/// }
+/// \endcode
+///
+/// \see sf::Texture, sf::RenderWindow
+///
+////////////////////////////////////////////////////////////
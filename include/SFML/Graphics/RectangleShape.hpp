@@ -90,6 +90,18 @@ public :
     ////////////////////////////////////////////////////////////
     virtual Vector2f getPoint(unsigned int index) const;
 
+protected :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the parameters that define the points of the shape
+    ///
+    /// \param parameters Receives the size of the rectangle
+    ///
+    /// \return Always true, identical rectangles share their geometry
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual bool getGeometryParameters(Vector2f& parameters) const;
+
 private :
 
     ////////////////////////////////////////////////////////////
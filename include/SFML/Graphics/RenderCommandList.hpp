@@ -0,0 +1,225 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2012 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+#ifndef SFML_RENDERCOMMANDLIST_HPP
+#define SFML_RENDERCOMMANDLIST_HPP
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Graphics/Export.hpp>
+#include <SFML/Graphics/RenderTarget.hpp>
+#include <SFML/Graphics/Drawable.hpp>
+#include <vector>
+
+
+namespace sf
+{
+////////////////////////////////////////////////////////////
+/// \brief Render target that records what is drawn to it,
+///        so that it can be replayed later
+///
+////////////////////////////////////////////////////////////
+class SFML_GRAPHICS_API RenderCommandList : public RenderTarget, public Drawable
+{
+public :
+
+    using RenderTarget::draw;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Default constructor
+    ///
+    /// Creates an empty command list.
+    ///
+    ////////////////////////////////////////////////////////////
+    RenderCommandList();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Remove all the recorded commands
+    ///
+    /// This function must be called before recording new
+    /// contents, otherwise they are appended to the previous
+    /// ones. The memory is kept, so that recording again
+    /// doesn't cause any allocation.
+    ///
+    ////////////////////////////////////////////////////////////
+    void clear();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the number of recorded state groups
+    ///
+    /// This is the number of draw calls needed to replay
+    /// the list.
+    ///
+    /// \return Number of state groups
+    ///
+    ////////////////////////////////////////////////////////////
+    unsigned int getGroupCount() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the total number of recorded vertices
+    ///
+    /// \return Number of vertices
+    ///
+    ////////////////////////////////////////////////////////////
+    unsigned int getVertexCount() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Return the size of the rendering region of the target
+    ///
+    /// A command list has no rendering region, so this
+    /// function always returns (0, 0).
+    ///
+    /// \return Size in pixels
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual Vector2u getSize() const;
+
+private :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Replay the recorded commands to a render target
+    ///
+    /// \param target Render target to draw to
+    /// \param states Current render states
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual void draw(RenderTarget& target, RenderStates states) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Record primitives instead of rendering them
+    ///
+    /// \param vertices    Pointer to the vertices
+    /// \param vertexCount Number of vertices in the array
+    /// \param indices     Indices of the vertices to draw, or NULL to draw them all in order
+    /// \param type        Type of primitives to draw
+    /// \param states      Render states to use for drawing
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual void render(const Vertex* vertices, unsigned int vertexCount, const IndexArray* indices,
+                        PrimitiveType type, const RenderStates& states);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Activate the target for rendering
+    ///
+    /// A command list never renders anything, so this
+    /// function always fails.
+    ///
+    /// \param active True to activate, false to deactivate
+    ///
+    /// \return Always false
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual bool activate(bool active);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Sequence of primitives sharing the same render states
+    ///
+    ////////////////////////////////////////////////////////////
+    struct Group
+    {
+        PrimitiveType  type;        ///< Type of primitives
+        BlendMode      blendMode;   ///< Blending mode
+        const Texture* texture;     ///< Texture
+        const Shader*  shader;      ///< Shader
+        unsigned int   firstVertex; ///< Index of the first vertex of the group
+        unsigned int   vertexCount; ///< Number of vertices in the group
+    };
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    std::vector<Vertex> m_vertices; ///< Pre-transformed vertices of all the groups
+    std::vector<Group>  m_groups;   ///< Recorded state groups
+};
+
+} // namespace sf
+
+
+#endif // SFML_RENDERCOMMANDLIST_HPP
+
+
+////////////////////////////////////////////////////////////
+/// \class sf::RenderCommandList
+/// \ingroup graphics
+///
+/// sf::RenderCommandList is a render target that doesn't
+/// render anything: it records everything that is drawn to
+/// it, so that it can be drawn again later, as many times as
+/// needed, with a single call. This saves the cost of walking
+/// through the original drawables (and their virtual draw
+/// functions) every frame, for contents that rarely change
+/// like a HUD or a static background.
+///
+/// The vertices are recorded already transformed by the
+/// transform of the render states they were drawn with,
+/// along with their texture, blend mode and shader.
+/// Consecutive draws that use the same render states are
+/// merged into a single group, so that replaying the list
+/// needs as few draw calls as possible.
+///
+/// A command list is replayed by drawing it to another render
+/// target. The transform given in the render states is applied
+/// on top of the recorded vertices; the other render states
+/// are ignored, each group keeps its recorded ones.
+///
+/// Only the references to the textures and shaders are recorded:
+/// they must stay alive as long as the command list is used,
+/// and their current contents (pixels, shader parameters) are
+/// the ones used when the list is replayed. sf::VertexBuffer
+/// contents live in the graphics card memory and are not
+/// recorded; neither is clear(), since a command list has
+/// no pixels.
+///
+/// Usage example:
+/// \code
+/// // Record the HUD once
+/// sf::RenderCommandList hud;
+/// hud.draw(background);
+/// hud.draw(score);
+/// hud.draw(lives);
+///
+/// while (window.isOpen())
+/// {
+///     ...
+///
+///     // Record it again only when something changes
+///     if (scoreChanged)
+///     {
+///         hud.clear();
+///         hud.draw(background);
+///         hud.draw(score);
+///         hud.draw(lives);
+///     }
+///
+///     window.clear();
+///     window.draw(world);
+///     window.draw(hud);
+///     window.display();
+/// }
+/// \endcode
+///
+/// \see sf::RenderTarget, sf::VertexArray
+///
+////////////////////////////////////////////////////////////
@@ -37,12 +37,15 @@
 #include <SFML/Graphics/RenderStates.hpp>
 #include <SFML/Graphics/PrimitiveType.hpp>
 #include <SFML/Graphics/Vertex.hpp>
+#include <SFML/Graphics/IndexArray.hpp>
 #include <SFML/System/NonCopyable.hpp>
+#include <vector>
 
 
 namespace sf
 {
 class Drawable;
+class VertexBuffer;
 
 ////////////////////////////////////////////////////////////
 /// \brief Base class for all render targets (window, texture, ...)
@@ -50,6 +53,22 @@ class Drawable;
 ////////////////////////////////////////////////////////////
 class SFML_GRAPHICS_API RenderTarget : NonCopyable
 {
+public :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Rendering statistics of a render target
+    ///
+    /// The counters accumulate until resetStatistics() is called.
+    ///
+    ////////////////////////////////////////////////////////////
+    struct Statistics
+    {
+        unsigned int drawCalls;           ///< Number of draw calls actually sent to OpenGL
+        unsigned int mergedDraws;         ///< Number of draws that were merged into a previous batch
+        unsigned int textureBindsAvoided; ///< Number of texture changes saved by sorting the deferred draws
+        unsigned int blendChangesAvoided; ///< Number of blend mode changes saved by sorting the deferred draws
+    };
+
 public :
 
     ////////////////////////////////////////////////////////////
@@ -244,6 +263,190 @@ public :
     void draw(const Vertex* vertices, unsigned int vertexCount,
               PrimitiveType type, const RenderStates& states = RenderStates::Default);
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Draw indexed primitives defined by an array of vertices
+    ///
+    /// The primitives are made of the vertices referenced by
+    /// \a indices, in the order of the indices. This allows
+    /// vertices shared by several primitives to be stored only
+    /// once. Indexed drawing is most useful with sf::Triangles.
+    ///
+    /// \param vertices    Pointer to the vertices
+    /// \param vertexCount Number of vertices in the array
+    /// \param indices     Indices of the vertices that make the primitives
+    /// \param type        Type of primitives to draw
+    /// \param states      Render states to use for drawing
+    ///
+    ////////////////////////////////////////////////////////////
+    void draw(const Vertex* vertices, unsigned int vertexCount, const IndexArray& indices,
+              PrimitiveType type, const RenderStates& states = RenderStates::Default);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Draw primitives stored in a vertex buffer
+    ///
+    /// \param vertexBuffer Vertex buffer to draw
+    /// \param states       Render states to use for drawing
+    ///
+    ////////////////////////////////////////////////////////////
+    void draw(const VertexBuffer& vertexBuffer, const RenderStates& states = RenderStates::Default);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Draw a range of primitives stored in a vertex buffer
+    ///
+    /// The primitives are read directly from the graphics card
+    /// memory, they are never batched (see setBatchingEnabled).
+    ///
+    /// \param vertexBuffer Vertex buffer to draw
+    /// \param firstVertex  Index of the first vertex to draw
+    /// \param vertexCount  Number of vertices to draw
+    /// \param states       Render states to use for drawing
+    ///
+    ////////////////////////////////////////////////////////////
+    void draw(const VertexBuffer& vertexBuffer, unsigned int firstVertex,
+              unsigned int vertexCount, const RenderStates& states = RenderStates::Default);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Enable or disable automatic batching of draw calls
+    ///
+    /// When batching is enabled, consecutive draws that use the
+    /// same texture, blend mode, shader and primitive type are
+    /// transformed on the CPU and accumulated into a single batch,
+    /// which is sent to the graphics card in one draw call only
+    /// when the render states change, when the target is displayed
+    /// or cleared, when the view changes, or when flush() is called.
+    /// Strips and fans are converted to their list equivalent
+    /// so that they can be merged too.
+    ///
+    /// Since batched primitives are rendered later than the
+    /// corresponding draw call, you must call flush() before
+    /// modifying a texture or shader that is used by pending
+    /// draws, or before issuing your own OpenGL commands.
+    ///
+    /// Batching is disabled by default.
+    ///
+    /// \param enabled True to enable batching, false to disable it
+    ///
+    /// \see isBatchingEnabled, flush
+    ///
+    ////////////////////////////////////////////////////////////
+    void setBatchingEnabled(bool enabled);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Tell whether automatic batching is enabled or not
+    ///
+    /// \return True if batching is enabled
+    ///
+    /// \see setBatchingEnabled
+    ///
+    ////////////////////////////////////////////////////////////
+    bool isBatchingEnabled() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Enable or disable deferred rendering
+    ///
+    /// When deferred rendering is enabled, draws are not rendered
+    /// immediately: they are pre-transformed and queued, tagged
+    /// with the current draw layer (see setDrawLayer). When the
+    /// queue is flushed, it is sorted by layer, then by shader,
+    /// texture and blend mode within each layer, so that draws
+    /// which share the same states end up next to each other;
+    /// combined with batching, they are then merged into fewer
+    /// draw calls.
+    ///
+    /// The queue is flushed in the same situations as the batch
+    /// (display, clear, view change, flush(), ...), so layers
+    /// are only sorted relative to each other between two such
+    /// events. Draws of vertex buffers are not deferred: they
+    /// flush the queue.
+    ///
+    /// Deferred rendering is disabled by default.
+    ///
+    /// \param enabled True to enable deferred rendering, false to disable it
+    ///
+    /// \see isDeferredEnabled, setDrawLayer, flush
+    ///
+    ////////////////////////////////////////////////////////////
+    void setDeferredEnabled(bool enabled);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Tell whether deferred rendering is enabled or not
+    ///
+    /// \return True if deferred rendering is enabled
+    ///
+    /// \see setDeferredEnabled
+    ///
+    ////////////////////////////////////////////////////////////
+    bool isDeferredEnabled() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Change the layer of the subsequent deferred draws
+    ///
+    /// Layers are rendered in increasing order, whatever the
+    /// order in which their draws were issued. Within a layer,
+    /// draws are sorted by render states, unless \a preserveOrder
+    /// is true: use it for draws that overlap and must be
+    /// rendered in the order they were issued (like translucent
+    /// entities). If a layer contains both kinds of draws, the
+    /// ones that preserve their order are rendered last, on top
+    /// of the sorted ones.
+    ///
+    /// The default layer is 0, with sorting allowed.
+    /// This function has no effect if deferred rendering is disabled.
+    ///
+    /// \param layer         Layer of the subsequent draws
+    /// \param preserveOrder True to render the subsequent draws in submission order
+    ///
+    /// \see getDrawLayer, setDeferredEnabled
+    ///
+    ////////////////////////////////////////////////////////////
+    void setDrawLayer(int layer, bool preserveOrder = false);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the layer of the subsequent deferred draws
+    ///
+    /// \return Current draw layer
+    ///
+    /// \see setDrawLayer
+    ///
+    ////////////////////////////////////////////////////////////
+    int getDrawLayer() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Render all the pending deferred and batched primitives
+    ///
+    /// This function is called automatically whenever it is
+    /// needed (state change, display, clear, view change, ...),
+    /// you only have to call it yourself before touching a
+    /// resource used by pending draws or before mixing SFML
+    /// drawing with direct OpenGL calls.
+    /// It does nothing if batching and deferred rendering are
+    /// disabled, or if there's nothing to render.
+    ///
+    /// \see setBatchingEnabled, setDeferredEnabled
+    ///
+    ////////////////////////////////////////////////////////////
+    void flush();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the rendering statistics of the target
+    ///
+    /// \return Statistics accumulated since the last call to resetStatistics
+    ///
+    /// \see resetStatistics
+    ///
+    ////////////////////////////////////////////////////////////
+    const Statistics& getStatistics() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Reset all the rendering statistics counters to zero
+    ///
+    /// This function is typically called once per frame.
+    ///
+    /// \see getStatistics
+    ///
+    ////////////////////////////////////////////////////////////
+    void resetStatistics();
+
     ////////////////////////////////////////////////////////////
     /// \brief Return the size of the rendering region of the target
     ///
@@ -339,6 +542,109 @@ protected :
 
 private:
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Add primitives to the current batch
+    ///
+    /// The batch is flushed first if the render states of the
+    /// new primitives are not compatible with it.
+    ///
+    /// \param vertices    Pointer to the vertices
+    /// \param vertexCount Number of vertices in the array
+    /// \param indices     Indices of the vertices to add, or NULL to add them all in order
+    /// \param type        Type of primitives to draw
+    /// \param states      Render states to use for drawing
+    ///
+    ////////////////////////////////////////////////////////////
+    void addToBatch(const Vertex* vertices, unsigned int vertexCount, const IndexArray* indices,
+                    PrimitiveType type, const RenderStates& states);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Add primitives to the batch, or render them directly
+    ///
+    /// \param vertices    Pointer to the vertices
+    /// \param vertexCount Number of vertices in the array
+    /// \param indices     Indices of the vertices to draw, or NULL to draw them all in order
+    /// \param type        Type of primitives to draw
+    /// \param states      Render states to use for drawing
+    ///
+    ////////////////////////////////////////////////////////////
+    void submit(const Vertex* vertices, unsigned int vertexCount, const IndexArray* indices,
+                PrimitiveType type, const RenderStates& states);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Add primitives to the deferred queue
+    ///
+    /// \param vertices    Pointer to the vertices
+    /// \param vertexCount Number of vertices in the array
+    /// \param indices     Indices of the vertices to draw, or NULL to draw them all in order
+    /// \param type        Type of primitives to draw
+    /// \param states      Render states to use for drawing
+    ///
+    ////////////////////////////////////////////////////////////
+    void enqueue(const Vertex* vertices, unsigned int vertexCount, const IndexArray* indices,
+                 PrimitiveType type, const RenderStates& states);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Sort the deferred queue and submit its primitives
+    ///
+    ////////////////////////////////////////////////////////////
+    void flushQueue();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Render the pending batched primitives
+    ///
+    ////////////////////////////////////////////////////////////
+    void flushBatch();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Send primitives to the graphics card
+    ///
+    /// All the primitives that are not batched, and the batches
+    /// themselves when they are flushed, end up in this function.
+    /// Derived classes can override it to capture the primitives
+    /// instead of rendering them.
+    ///
+    /// \param vertices    Pointer to the vertices
+    /// \param vertexCount Number of vertices in the array
+    /// \param indices     Indices of the vertices to draw, or NULL to draw them all in order
+    /// \param type        Type of primitives to draw
+    /// \param states      Render states to use for drawing
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual void render(const Vertex* vertices, unsigned int vertexCount, const IndexArray* indices,
+                        PrimitiveType type, const RenderStates& states);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Apply the render states before a draw call
+    ///
+    /// \param useVertexCache Are the vertices pre-transformed into the vertex cache?
+    /// \param states         Render states to apply
+    ///
+    ////////////////////////////////////////////////////////////
+    void setupDraw(bool useVertexCache, const RenderStates& states);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Issue the draw call for the currently bound vertices
+    ///
+    /// Quads are rendered as pairs of indexed triangles, in which
+    /// case \a firstVertex must be 0.
+    ///
+    /// \param type        Type of primitives to draw
+    /// \param firstVertex Index of the first vertex to draw
+    /// \param vertexCount Number of vertices to draw
+    ///
+    ////////////////////////////////////////////////////////////
+    void drawPrimitives(PrimitiveType type, unsigned int firstVertex, unsigned int vertexCount);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Issue the draw call for the currently bound vertices, using indices
+    ///
+    /// \param type    Type of primitives to draw
+    /// \param indices Indices of the vertices to draw
+    ///
+    ////////////////////////////////////////////////////////////
+    void drawIndexedPrimitives(PrimitiveType type, const IndexArray& indices);
+
     ////////////////////////////////////////////////////////////
     /// \brief Apply the current view
     ///
@@ -372,7 +678,10 @@ private:
     ////////////////////////////////////////////////////////////
     /// \brief Apply a new shader
     ///
-    /// \param shader Shader to apply
+    /// The program and the textures of the shader are bound
+    /// only if they differ from the cached ones.
+    ///
+    /// \param shader Shader to apply, or NULL to unbind the current one
     ///
     ////////////////////////////////////////////////////////////
     void applyShader(const Shader* shader);
@@ -397,22 +706,77 @@ private:
     ////////////////////////////////////////////////////////////
     struct StatesCache
     {
-        enum {VertexCacheSize = 4};
-
-        bool      glStatesSet;    ///< Are our internal GL states set yet?
-        bool      viewChanged;    ///< Has the current view changed since last draw?
-        BlendMode lastBlendMode;  ///< Cached blending mode
-        Uint64    lastTextureId;  ///< Cached texture
-        bool      useVertexCache; ///< Did we previously use the vertex cache?
-        Vertex    vertexCache[VertexCacheSize]; ///< Pre-transformed vertices cache
+        enum {VertexCacheSize = 4, TextureUnitCount = 32};
+
+        bool          glStatesSet;    ///< Are our internal GL states set yet?
+        bool          viewChanged;    ///< Has the current view changed since last draw?
+        BlendMode     lastBlendMode;  ///< Cached blending mode
+        Uint64        lastTextureId;  ///< Cached texture
+        Uint64        lastShaderId;   ///< Cached shader program and texture units layout
+        Uint64        lastUnitTextureIds[TextureUnitCount]; ///< Cached textures of the units used by shaders (unit 0 is lastTextureId)
+        const Vertex* lastVertexData; ///< Cached address of the vertex arrays, NULL if unknown
+        bool          useVertexCache; ///< Did we previously use the vertex cache?
+        Vertex        vertexCache[VertexCacheSize]; ///< Pre-transformed vertices cache
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Pending primitives waiting to be rendered together
+    ///
+    ////////////////////////////////////////////////////////////
+    struct Batch
+    {
+        enum {MaxDrawSize = 1024};
+
+        bool                enabled;   ///< Is batching enabled?
+        std::vector<Vertex> vertices;  ///< Pre-transformed vertices of the batch
+        PrimitiveType       type;      ///< Type of primitives of the batch (always a list type)
+        BlendMode           blendMode; ///< Blending mode of the batch
+        const Texture*      texture;   ///< Texture of the batch
+        Uint64              textureId; ///< Unique identifier of the texture, at the time it was batched
+        const Shader*       shader;    ///< Shader of the batch
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Deferred draw waiting in the queue
+    ///
+    ////////////////////////////////////////////////////////////
+    struct Command
+    {
+        int            layer;         ///< Layer of the draw
+        bool           preserveOrder; ///< Must the draw keep its submission order within its layer?
+        PrimitiveType  type;          ///< Type of primitives
+        BlendMode      blendMode;     ///< Blending mode
+        const Texture* texture;       ///< Texture
+        Uint64         textureId;     ///< Unique identifier of the texture, at the time it was queued
+        const Shader*  shader;        ///< Shader
+        unsigned int   firstVertex;   ///< Index of the first vertex of the draw in the queue
+        unsigned int   vertexCount;   ///< Number of vertices of the draw
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Deferred draws waiting to be sorted and rendered
+    ///
+    ////////////////////////////////////////////////////////////
+    struct Queue
+    {
+        bool                 enabled;       ///< Is deferred rendering enabled?
+        int                  layer;         ///< Layer of the subsequent draws
+        bool                 preserveOrder; ///< Do the subsequent draws keep their submission order?
+        std::vector<Command> commands;      ///< Queued draws, in submission order
+        std::vector<Vertex>  vertices;      ///< Pre-transformed vertices of the queued draws
     };
 
     ////////////////////////////////////////////////////////////
     // Member data
     ////////////////////////////////////////////////////////////
-    View        m_defaultView; ///< Default view
-    View        m_view;        ///< Current view
-    StatesCache m_cache;       ///< Render states cache
+    View        m_defaultView;   ///< Default view
+    View        m_view;          ///< Current view
+    StatesCache m_cache;         ///< Render states cache
+    Batch       m_batch;         ///< Pending batched primitives
+    Queue       m_queue;         ///< Pending deferred draws
+    IndexArray  m_quadIndices;   ///< Indices used to render quads as pairs of triangles
+    IndexArray  m_quadTriangles; ///< Indexed quads converted to triangles (kept to avoid allocations)
+    Statistics  m_statistics;    ///< Rendering statistics
 };
 
 } // namespace sf
@@ -443,6 +807,36 @@ private:
 /// OpenGL states are not messed up by calling the
 /// pushGLStates/popGLStates functions.
 ///
+/// When a scene is made of many small entities sharing the same
+/// texture (sprites of a tileset, characters of a text, ...),
+/// batching can be enabled with setBatchingEnabled: consecutive
+/// compatible draws are then merged and sent to the graphics card
+/// with a single draw call.
+/// \code
+/// window.setBatchingEnabled(true);
+/// for (std::size_t i = 0; i < sprites.size(); ++i)
+///     window.draw(sprites[i]); // all these sprites share the same texture
+/// window.display(); // the whole batch is rendered with a single draw call
+/// \endcode
+///
+/// When draws using different textures are interleaved, deferred
+/// rendering (setDeferredEnabled) can reorder them by layer and
+/// render states, so that fewer state changes and draw calls are
+/// needed.
+/// \code
+/// window.setBatchingEnabled(true);
+/// window.setDeferredEnabled(true);
+///
+/// window.setDrawLayer(0);
+/// for (std::size_t i = 0; i < entities.size(); ++i)
+///     window.draw(entities[i]); // sorted by texture, whatever their order
+///
+/// window.setDrawLayer(1, true);
+/// window.draw(hud); // rendered after the entities, in submission order
+///
+/// window.display();
+/// \endcode
+///
 /// \see sf::RenderWindow, sf::RenderTexture, sf::View
 ///
 ////////////////////////////////////////////////////////////
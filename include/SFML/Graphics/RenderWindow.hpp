@@ -148,6 +148,17 @@ protected:
     ////////////////////////////////////////////////////////////
     virtual void onResize();
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Function called before the window contents are displayed
+    ///
+    /// The primitives still pending in the draw batch or the
+    /// deferred queue (see RenderTarget::setBatchingEnabled)
+    /// are rendered, so that they are part of the displayed
+    /// frame even when display() is called through a sf::Window.
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual void onDisplay();
+
 private :
 
     ////////////////////////////////////////////////////////////
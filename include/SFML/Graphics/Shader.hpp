@@ -476,6 +476,8 @@ public :
 
 private :
 
+    friend class RenderTarget;
+
     ////////////////////////////////////////////////////////////
     /// \brief Compile the shader(s) and create the program
     ///
@@ -499,17 +501,67 @@ private :
     ////////////////////////////////////////////////////////////
     void bindTextures() const;
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the location of a variable of the shader
+    ///
+    /// Locations are requested to OpenGL only the first time,
+    /// then they are cached.
+    ///
+    /// \param name Name of the variable
+    ///
+    /// \return Location of the variable, or -1 if it doesn't exist
+    ///
+    ////////////////////////////////////////////////////////////
+    int getParameterLocation(const std::string& name);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Store the new value of a parameter until the shader is bound
+    ///
+    /// \param name   Name of the parameter
+    /// \param values Components of the value
+    /// \param size   Number of components (1 to 4, or 16 for a matrix)
+    ///
+    ////////////////////////////////////////////////////////////
+    void stageParameter(const std::string& name, const float* values, int size);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Upload the parameters that changed to the program
+    ///
+    /// The program must be bound when this function is called.
+    ///
+    ////////////////////////////////////////////////////////////
+    void uploadParameters() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Value of a parameter, stored until it is uploaded
+    ///
+    ////////////////////////////////////////////////////////////
+    struct Parameter
+    {
+        Parameter() : size(0), changed(false) {}
+
+        int   size;       ///< Number of components of the value (1 to 4, or 16 for a matrix)
+        float values[16]; ///< Components of the value
+        bool  changed;    ///< Has the value changed since it was last uploaded?
+    };
+
     ////////////////////////////////////////////////////////////
     // Types
     ////////////////////////////////////////////////////////////
     typedef std::map<int, const Texture*> TextureTable;
+    typedef std::map<std::string, int> LocationTable;
+    typedef std::map<int, Parameter> ParameterTable;
 
     ////////////////////////////////////////////////////////////
     // Member data
     ////////////////////////////////////////////////////////////
-    unsigned int m_shaderProgram;  ///< OpenGL identifier for the program
-    int          m_currentTexture; ///< Location of the current texture in the shader
-    TextureTable m_textures;       ///< Texture variables in the shader, mapped to their location
+    unsigned int           m_shaderProgram;     ///< OpenGL identifier for the program
+    int                    m_currentTexture;    ///< Location of the current texture in the shader
+    TextureTable           m_textures;          ///< Texture variables in the shader, mapped to their location
+    LocationTable          m_locations;         ///< Cached locations of the variables, mapped to their name
+    mutable ParameterTable m_parameters;        ///< Values of the parameters, mapped to their location
+    mutable bool           m_parametersChanged; ///< Has any parameter changed since the last upload?
+    Uint64                 m_cacheId;           ///< Unique number that identifies the program and its texture units to the render target's cache
 };
 
 } // namespace sf
@@ -563,6 +615,12 @@ private :
 /// given texture variable to the current texture of the
 /// object being drawn (which cannot be known in advance).
 ///
+/// Setting a parameter is cheap: the location of each variable
+/// is requested to OpenGL only once, and the new values are
+/// stored and uploaded together the next time the shader is
+/// bound for drawing. Values that didn't change are not
+/// uploaded again.
+///
 /// To apply a shader to a drawable, you must pass it as an
 /// additional parameter to the Draw function:
 /// \code
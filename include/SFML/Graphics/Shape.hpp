@@ -37,6 +37,11 @@
 
 namespace sf
 {
+namespace priv
+{
+    class ShapeGeometry;
+}
+
 ////////////////////////////////////////////////////////////
 /// \brief Base class for textured shapes with outline
 ///
@@ -123,6 +128,8 @@ public :
     /// expands towards the center of the shape), and using zero
     /// disables the outline.
     /// By default, the outline thickness is 0.
+    /// Changing the thickness only recomputes the outline, the
+    /// points of the shape are not requested again.
     ///
     /// \param thickness New outline thickness
     ///
@@ -245,18 +252,63 @@ protected :
     ////////////////////////////////////////////////////////////
     Shape();
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Copy constructor
+    ///
+    /// \param copy Instance to copy
+    ///
+    ////////////////////////////////////////////////////////////
+    Shape(const Shape& copy);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Overload of assignment operator
+    ///
+    /// \param right Instance to assign
+    ///
+    /// \return Reference to self
+    ///
+    ////////////////////////////////////////////////////////////
+    Shape& operator =(const Shape& right);
+
     ////////////////////////////////////////////////////////////
     /// \brief Recompute the internal geometry of the shape
     ///
     /// This function must be called by the derived class everytime
     /// the shape's points change (ie. the result of either
     /// getPointCount or getPoint is different).
+    /// If the derived class describes its points with
+    /// getGeometryParameters, the points, outline and bounds
+    /// are shared by all the shapes of the same class that have
+    /// the same parameters, point count and outline thickness:
+    /// they are computed only once, and getPoint is not called
+    /// for the other shapes.
     ///
     ////////////////////////////////////////////////////////////
     void update();
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the parameters that define the points of the shape
+    ///
+    /// Derived classes whose points depend only on their point
+    /// count and on up to two values (like the radius of a
+    /// circle, or the size of a rectangle) can override this
+    /// function so that identical shapes share their geometry.
+    /// A class that overrides getPoint must also override this
+    /// function if its points depend on other values.
+    /// The default implementation returns false: the geometry
+    /// of the shape is not shared.
+    ///
+    /// \param parameters Receives the parameters of the shape
+    ///
+    /// \return True if the geometry of the shape can be shared
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual bool getGeometryParameters(Vector2f& parameters) const;
+
 private :
 
+    friend class ShapeBatch;
+
     ////////////////////////////////////////////////////////////
     /// \brief Draw the shape to a render target
     ///
@@ -284,26 +336,66 @@ private :
     ////////////////////////////////////////////////////////////
     void updateOutline();
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Change the shared geometry used by the shape
+    ///
+    /// The current geometry is released, and the shape takes
+    /// over the reference to \a geometry.
+    ///
+    /// \param geometry New geometry (can be NULL)
+    ///
+    ////////////////////////////////////////////////////////////
+    void setGeometry(const priv::ShapeGeometry* geometry);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Copy the points, outline and bounds of the shared geometry
+    ///
+    ////////////////////////////////////////////////////////////
+    void copyGeometry();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Copy the outline and bounds of the shared geometry
+    ///
+    ////////////////////////////////////////////////////////////
+    void copyOutline();
+
     ////////////////////////////////////////////////////////////
     /// \brief Update the outline vertices' color
     ///
     ////////////////////////////////////////////////////////////
     void updateOutlineColors();
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Compute the outline positions of a set of points
+    ///
+    /// The outline is a triangle strip that goes around the
+    /// points, its first two vertices being repeated at the end:
+    /// \a outline must have room for (count + 1) * 2 vertices.
+    /// Only the positions of the outline vertices are written.
+    ///
+    /// \param points    Vertices whose positions are the points of the shape
+    /// \param count     Number of points
+    /// \param thickness Thickness of the outline
+    /// \param outline   Receives the outline vertices
+    ///
+    ////////////////////////////////////////////////////////////
+    static void computeOutline(const Vertex* points, unsigned int count, float thickness, Vertex* outline);
+
 private :
 
     ////////////////////////////////////////////////////////////
     // Member data
     ////////////////////////////////////////////////////////////
-    const Texture* m_texture;          ///< Texture of the shape
-    IntRect        m_textureRect;      ///< Rectangle defining the area of the source texture to display
-    Color          m_fillColor;        ///< Fill color
-    Color          m_outlineColor;     ///< Outline color
-    float          m_outlineThickness; ///< Thickness of the shape's outline
-    VertexArray    m_vertices;         ///< Vertex array containing the fill geometry
-    VertexArray    m_outlineVertices;  ///< Vertex array containing the outline geometry
-    FloatRect      m_insideBounds;     ///< Bounding rectangle of the inside (fill)
-    FloatRect      m_bounds;           ///< Bounding rectangle of the whole shape (outline + fill)
+    const Texture*             m_texture;          ///< Texture of the shape
+    IntRect                    m_textureRect;      ///< Rectangle defining the area of the source texture to display
+    Color                      m_fillColor;        ///< Fill color
+    Color                      m_outlineColor;     ///< Outline color
+    float                      m_outlineThickness; ///< Thickness of the shape's outline
+    VertexArray                m_vertices;         ///< Vertex array containing the fill geometry
+    VertexArray                m_outlineVertices;  ///< Vertex array containing the outline geometry
+    FloatRect                  m_insideBounds;     ///< Bounding rectangle of the inside (fill)
+    FloatRect                  m_bounds;           ///< Bounding rectangle of the whole shape (outline + fill)
+    const priv::ShapeGeometry* m_geometry;         ///< Geometry shared with the identical shapes, if any
 };
 
 } // namespace sf
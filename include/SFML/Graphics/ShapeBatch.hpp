@@ -0,0 +1,223 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2012 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+#ifndef SFML_SHAPEBATCH_HPP
+#define SFML_SHAPEBATCH_HPP
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Graphics/Export.hpp>
+#include <SFML/Graphics/Drawable.hpp>
+#include <SFML/Graphics/Vertex.hpp>
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/Graphics/Color.hpp>
+#include <vector>
+
+
+namespace sf
+{
+class Shape;
+
+////////////////////////////////////////////////////////////
+/// \brief Drawable that renders a large number of untextured
+///        shapes in a single draw call
+///
+////////////////////////////////////////////////////////////
+class SFML_GRAPHICS_API ShapeBatch : public Drawable
+{
+public :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Default constructor
+    ///
+    /// Creates an empty batch.
+    ///
+    ////////////////////////////////////////////////////////////
+    ShapeBatch();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Add a copy of an existing shape to the batch
+    ///
+    /// The fill and outline of the shape are copied with its
+    /// transform applied. Its texture is ignored.
+    ///
+    /// \param shape Shape to add
+    ///
+    ////////////////////////////////////////////////////////////
+    void add(const Shape& shape);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Add a rectangle to the batch
+    ///
+    /// \param rectangle        Rectangle to add
+    /// \param fillColor        Fill color of the rectangle
+    /// \param outlineThickness Thickness of the outline (0 for no outline)
+    /// \param outlineColor     Color of the outline
+    ///
+    ////////////////////////////////////////////////////////////
+    void addRectangle(const FloatRect& rectangle, const Color& fillColor,
+                      float outlineThickness = 0.f, const Color& outlineColor = Color::White);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Add a circle to the batch
+    ///
+    /// \param center           Center of the circle
+    /// \param radius           Radius of the circle
+    /// \param fillColor        Fill color of the circle
+    /// \param outlineThickness Thickness of the outline (0 for no outline)
+    /// \param outlineColor     Color of the outline
+    /// \param pointCount       Number of points used to approximate the circle
+    ///
+    ////////////////////////////////////////////////////////////
+    void addCircle(const Vector2f& center, float radius, const Color& fillColor,
+                   float outlineThickness = 0.f, const Color& outlineColor = Color::White, unsigned int pointCount = 30);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Add a convex polygon to the batch
+    ///
+    /// The points must be given in clockwise or counter-clockwise
+    /// order, like in sf::ConvexShape. Polygons with less than
+    /// 3 points are ignored.
+    ///
+    /// \param points           Array of points of the polygon
+    /// \param pointCount       Number of points in the array
+    /// \param fillColor        Fill color of the polygon
+    /// \param outlineThickness Thickness of the outline (0 for no outline)
+    /// \param outlineColor     Color of the outline
+    ///
+    ////////////////////////////////////////////////////////////
+    void addPolygon(const Vector2f* points, unsigned int pointCount, const Color& fillColor,
+                    float outlineThickness = 0.f, const Color& outlineColor = Color::White);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Remove all the shapes from the batch
+    ///
+    /// The memory is kept, so that filling the batch again
+    /// in the next frame doesn't cause any allocation.
+    ///
+    ////////////////////////////////////////////////////////////
+    void clear();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Return the number of shapes in the batch
+    ///
+    /// \return Number of shapes
+    ///
+    ////////////////////////////////////////////////////////////
+    unsigned int getShapeCount() const;
+
+private :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Draw the shapes to a render target
+    ///
+    /// \param target Render target to draw to
+    /// \param states Current render states
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual void draw(RenderTarget& target, RenderStates states) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Add the triangles of a convex polygon and its outline
+    ///
+    /// The points are read from m_points.
+    ///
+    /// \param fillColor        Fill color of the polygon
+    /// \param outlineThickness Thickness of the outline (0 for no outline)
+    /// \param outlineColor     Color of the outline
+    ///
+    ////////////////////////////////////////////////////////////
+    void addPoints(const Color& fillColor, float outlineThickness, const Color& outlineColor);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Add the triangles of a triangle strip
+    ///
+    /// \param strip Vertices of the triangle strip
+    /// \param count Number of vertices in the strip
+    ///
+    ////////////////////////////////////////////////////////////
+    void addStrip(const Vertex* strip, std::size_t count);
+
+private :
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    std::vector<Vertex> m_vertices;   ///< Triangles of the fills and outlines, in submission order
+    std::vector<Vertex> m_points;     ///< Points of the polygon being added
+    std::vector<Vertex> m_strip;      ///< Vertices of the shape being added, before triangulation
+    unsigned int        m_shapeCount; ///< Number of shapes in the batch
+};
+
+} // namespace sf
+
+
+#endif // SFML_SHAPEBATCH_HPP
+
+
+////////////////////////////////////////////////////////////
+/// \class sf::ShapeBatch
+/// \ingroup graphics
+///
+/// sf::ShapeBatch draws many untextured shapes at once. Drawing
+/// sf::Shape instances one by one costs two draw calls per shape,
+/// one for the fill and one for the outline; a shape batch
+/// instead triangulates the fills and outlines of all its shapes
+/// into a single array of triangles, which is drawn with one
+/// draw call.
+///
+/// Shapes are added either by copying an existing sf::Shape
+/// (with its transform applied) or directly from a rectangle,
+/// circle or convex polygon description, which avoids creating
+/// shape objects at all. They are drawn in the order they were
+/// added, each shape's outline being drawn over its fill.
+///
+/// The typical usage is to clear the batch, add all the visible
+/// shapes and draw it, once per frame. The transform, blend mode
+/// and shader of the render states apply to all the shapes;
+/// textures are not supported.
+///
+/// Usage example:
+/// \code
+/// sf::ShapeBatch batch;
+///
+/// while (window.isOpen())
+/// {
+///     ...
+///
+///     batch.clear();
+///     for (std::size_t i = 0; i < units.size(); ++i)
+///         batch.addCircle(units[i].position, 4, sf::Color::Green, 1, sf::Color::Black);
+///     batch.addRectangle(selection, sf::Color(0, 0, 255, 64), 1);
+///
+///     window.clear();
+///     window.draw(batch);
+///     window.display();
+/// }
+/// \endcode
+///
+/// \see sf::Shape, sf::SpriteBatch
+///
+////////////////////////////////////////////////////////////
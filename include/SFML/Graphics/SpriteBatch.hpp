@@ -0,0 +1,238 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2012 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+#ifndef SFML_SPRITEBATCH_HPP
+#define SFML_SPRITEBATCH_HPP
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Graphics/Export.hpp>
+#include <SFML/Graphics/Drawable.hpp>
+#include <SFML/Graphics/Vertex.hpp>
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/Graphics/Color.hpp>
+#include <vector>
+
+
+namespace sf
+{
+class Texture;
+class Sprite;
+class Transformable;
+
+////////////////////////////////////////////////////////////
+/// \brief Drawable that renders a large number of sprites
+///        with as few draw calls as possible
+///
+////////////////////////////////////////////////////////////
+class SFML_GRAPHICS_API SpriteBatch : public Drawable
+{
+public :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Order in which the sprites are drawn
+    ///
+    ////////////////////////////////////////////////////////////
+    enum SortMode
+    {
+        Submission, ///< Sprites are drawn in the order they were added
+        ByTexture,  ///< Sprites are grouped by texture, to minimize the number of draw calls
+        BackToFront ///< Sprites are drawn from the highest depth to the lowest one
+    };
+
+public :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Default constructor
+    ///
+    /// Creates an empty batch, which draws its sprites
+    /// in submission order.
+    ///
+    ////////////////////////////////////////////////////////////
+    SpriteBatch();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Construct the batch with a sort mode
+    ///
+    /// \param sortMode Order in which the sprites are drawn
+    ///
+    ////////////////////////////////////////////////////////////
+    explicit SpriteBatch(SortMode sortMode);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Add a sprite to the batch
+    ///
+    /// The position, rotation, scale and origin of the sprite
+    /// are taken from \a transformable. The texture must remain
+    /// alive as long as the batch uses it.
+    ///
+    /// \param texture       Texture of the sprite
+    /// \param textureRect   Part of the texture to display
+    /// \param transformable Transformations of the sprite
+    /// \param color         Global color of the sprite
+    /// \param depth         Depth of the sprite, used by the BackToFront sort mode
+    ///
+    ////////////////////////////////////////////////////////////
+    void add(const Texture& texture, const IntRect& textureRect, const Transformable& transformable,
+             const Color& color = Color::White, float depth = 0.f);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Add a copy of an existing sprite to the batch
+    ///
+    /// Sprites that have no texture are ignored.
+    ///
+    /// \param sprite Sprite to add
+    /// \param depth  Depth of the sprite, used by the BackToFront sort mode
+    ///
+    ////////////////////////////////////////////////////////////
+    void add(const Sprite& sprite, float depth = 0.f);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Remove all the sprites from the batch
+    ///
+    /// The memory is kept, so that filling the batch again
+    /// in the next frame doesn't cause any allocation.
+    ///
+    ////////////////////////////////////////////////////////////
+    void clear();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Return the number of sprites in the batch
+    ///
+    /// \return Number of sprites
+    ///
+    ////////////////////////////////////////////////////////////
+    unsigned int getSpriteCount() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Change the order in which the sprites are drawn
+    ///
+    /// The default sort mode is Submission.
+    ///
+    /// \param sortMode New sort mode
+    ///
+    ////////////////////////////////////////////////////////////
+    void setSortMode(SortMode sortMode);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the order in which the sprites are drawn
+    ///
+    /// \return Current sort mode
+    ///
+    ////////////////////////////////////////////////////////////
+    SortMode getSortMode() const;
+
+private :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Draw the sprites to a render target
+    ///
+    /// \param target Render target to draw to
+    /// \param states Current render states
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual void draw(RenderTarget& target, RenderStates states) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Sort the sprites and rebuild the vertices
+    ///
+    ////////////////////////////////////////////////////////////
+    void update() const;
+
+private :
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    SortMode                          m_sortMode;     ///< Order in which the sprites are drawn
+    std::vector<Vector2f>             m_positions;    ///< Position of each sprite
+    std::vector<Vector2f>             m_origins;      ///< Origin of each sprite
+    std::vector<Vector2f>             m_scales;       ///< Scale of each sprite
+    std::vector<float>                m_rotations;    ///< Rotation of each sprite, in degrees
+    std::vector<IntRect>              m_textureRects; ///< Texture rectangle of each sprite
+    std::vector<Color>                m_colors;       ///< Color of each sprite
+    std::vector<const Texture*>       m_textures;     ///< Texture of each sprite
+    std::vector<float>                m_depths;       ///< Depth of each sprite
+    mutable std::vector<unsigned int> m_order;        ///< Indices of the sprites, in drawing order
+    mutable std::vector<Vertex>       m_vertices;     ///< Quads of the sprites, in drawing order
+    mutable bool                      m_needUpdate;   ///< Do we need to rebuild the vertices?
+};
+
+} // namespace sf
+
+
+#endif // SFML_SPRITEBATCH_HPP
+
+
+////////////////////////////////////////////////////////////
+/// \class sf::SpriteBatch
+/// \ingroup graphics
+///
+/// sf::SpriteBatch draws many textured quads at once. Drawing
+/// sf::Sprite instances one by one costs a full state setup
+/// and a draw call per sprite; a sprite batch instead stores
+/// the sprites' attributes in contiguous arrays, generates all
+/// their quads in a single vertex array and draws them with
+/// one draw call per texture.
+///
+/// Sprites are added either from their attributes (texture,
+/// texture rectangle, transformations and color) or by copying
+/// an existing sf::Sprite. The batch doesn't keep any reference
+/// to the sprites or transformables that were added, but it does
+/// keep a pointer to their textures.
+///
+/// The sort mode controls the order in which the sprites are
+/// drawn:
+/// \li Submission keeps the order in which they were added
+/// \li ByTexture groups them by texture, which gives the fewest
+///     draw calls when the sprites don't overlap
+/// \li BackToFront draws them from the highest depth to the
+///     lowest, sprites with the same depth keep their order
+///
+/// The typical usage is to clear the batch, add all the visible
+/// sprites and draw it, once per frame. The transform, blend mode
+/// and shader of the render states apply to all the sprites.
+///
+/// Usage example:
+/// \code
+/// sf::SpriteBatch batch(sf::SpriteBatch::ByTexture);
+///
+/// while (window.isOpen())
+/// {
+///     ...
+///
+///     batch.clear();
+///     for (std::size_t i = 0; i < entities.size(); ++i)
+///         batch.add(entities[i].texture, entities[i].rect, entities[i].transformable);
+///
+///     window.clear();
+///     window.draw(batch);
+///     window.display();
+/// }
+/// \endcode
+///
+/// \see sf::Sprite, sf::VertexArray
+///
+////////////////////////////////////////////////////////////
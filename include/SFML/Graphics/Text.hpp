@@ -93,6 +93,11 @@ public :
     /// \endcode
     /// A text's string is empty by default.
     ///
+    /// If the new string starts with the current one (i.e. text
+    /// is appended), only the new characters are laid out; this
+    /// keeps logs and consoles that grow one line at a time cheap
+    /// to update, whatever their length.
+    ///
     /// \param string New string
     ///
     /// \see getString
@@ -265,6 +270,8 @@ public :
 
 private :
 
+    friend class TextBatch;
+
     ////////////////////////////////////////////////////////////
     /// \brief Draw the text to a render target
     ///
@@ -280,6 +287,18 @@ private :
     ////////////////////////////////////////////////////////////
     void updateGeometry();
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Add the geometry of the end of the string
+    ///
+    /// The characters are laid out from the position where the
+    /// previous ones stopped, and their quads are appended to the
+    /// current geometry.
+    ///
+    /// \param first Index of the first character to add
+    ///
+    ////////////////////////////////////////////////////////////
+    void appendGeometry(std::size_t first);
+
     ////////////////////////////////////////////////////////////
     // Member data
     ////////////////////////////////////////////////////////////
@@ -290,6 +309,9 @@ private :
     Color         m_color;         ///< Text color
     VertexArray   m_vertices;      ///< Vertex array containing the text's geometry
     FloatRect     m_bounds;        ///< Bounding rectangle of the text (in local coordinates)
+    FloatRect     m_glyphBounds;   ///< Bounding rectangle of the geometry, without the underline of the last line
+    TextLayout    m_layout;        ///< Positions of the characters
+    Uint32        m_revision;      ///< Incremented every time the geometry changes
 };
 
 } // namespace sf
@@ -0,0 +1,229 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2012 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+#ifndef SFML_TEXTBATCH_HPP
+#define SFML_TEXTBATCH_HPP
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Graphics/Export.hpp>
+#include <SFML/Graphics/Drawable.hpp>
+#include <SFML/Graphics/Vertex.hpp>
+#include <SFML/Graphics/Transform.hpp>
+#include <SFML/System/NonCopyable.hpp>
+#include <vector>
+
+
+namespace sf
+{
+class Font;
+class Text;
+class VertexBuffer;
+
+////////////////////////////////////////////////////////////
+/// \brief Drawable that renders many texts sharing the same
+///        fonts with as few draw calls as possible
+///
+////////////////////////////////////////////////////////////
+class SFML_GRAPHICS_API TextBatch : public Drawable, NonCopyable
+{
+public :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Default constructor
+    ///
+    /// Creates an empty batch.
+    ///
+    ////////////////////////////////////////////////////////////
+    TextBatch();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Destructor
+    ///
+    ////////////////////////////////////////////////////////////
+    ~TextBatch();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Add a text to the batch
+    ///
+    /// The batch keeps a pointer to \a text, which must remain
+    /// alive as long as it is in the batch. Adding a text that
+    /// is already in the batch does nothing.
+    ///
+    /// \param text Text to add
+    ///
+    ////////////////////////////////////////////////////////////
+    void add(const Text& text);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Remove a text from the batch
+    ///
+    /// \param text Text to remove
+    ///
+    ////////////////////////////////////////////////////////////
+    void remove(const Text& text);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Remove all the texts from the batch
+    ///
+    ////////////////////////////////////////////////////////////
+    void clear();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Return the number of texts in the batch
+    ///
+    /// \return Number of texts
+    ///
+    ////////////////////////////////////////////////////////////
+    unsigned int getTextCount() const;
+
+private :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Draw the texts to a render target
+    ///
+    /// \param target Render target to draw to
+    /// \param states Current render states
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual void draw(RenderTarget& target, RenderStates states) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Update the vertices of the texts that have changed
+    ///
+    ////////////////////////////////////////////////////////////
+    void update() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the group of a font and character size
+    ///
+    /// The group is created if it doesn't exist yet.
+    ///
+    /// \param font          Font of the texts
+    /// \param characterSize Character size of the texts
+    ///
+    /// \return Index of the group
+    ///
+    ////////////////////////////////////////////////////////////
+    std::size_t getGroup(const Font* font, unsigned int characterSize) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Regenerate all the vertices of a group
+    ///
+    /// \param group Index of the group
+    ///
+    ////////////////////////////////////////////////////////////
+    void rebuildGroup(std::size_t group) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Structure defining the texts that share a font and a character size
+    ///
+    ////////////////////////////////////////////////////////////
+    struct Group
+    {
+        const Font*         font;          ///< Font of the texts
+        unsigned int        characterSize; ///< Character size of the texts
+        std::vector<Vertex> vertices;      ///< Quads of all the texts of the group, with their transform applied
+        VertexBuffer*       buffer;        ///< Copy of the vertices in graphics memory (NULL if vertex buffers are not supported)
+        bool                needRebuild;   ///< Has a text been added, removed or resized since the last update?
+        std::size_t         dirtyBegin;    ///< First vertex not uploaded to the buffer yet
+        std::size_t         dirtyEnd;      ///< Vertex following the last one not uploaded to the buffer yet
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Structure defining a text of the batch
+    ///
+    ////////////////////////////////////////////////////////////
+    struct Entry
+    {
+        const Text* text;        ///< Text
+        std::size_t group;       ///< Index of the group of the text
+        std::size_t offset;      ///< Index of the first vertex of the text in its group
+        std::size_t vertexCount; ///< Number of vertices of the text in its group
+        Uint32      revision;    ///< Revision of the text's geometry when it was copied
+        Transform   transform;   ///< Transform of the text when it was copied
+    };
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    mutable std::vector<Entry> m_entries; ///< Texts of the batch, in submission order
+    mutable std::vector<Group> m_groups;  ///< Groups of texts sharing a font and a character size
+};
+
+} // namespace sf
+
+
+#endif // SFML_TEXTBATCH_HPP
+
+
+////////////////////////////////////////////////////////////
+/// \class sf::TextBatch
+/// \ingroup graphics
+///
+/// sf::TextBatch draws many sf::Text instances at once. Drawing
+/// texts one by one costs a draw call per text, even though
+/// texts that use the same font and character size share the
+/// same glyph texture. A text batch instead copies the quads
+/// of these texts, with their transform applied, into a single
+/// vertex buffer and draws them with one draw call.
+///
+/// Unlike sf::SpriteBatch, which is filled again every frame,
+/// a text batch keeps pointers to its texts and follows their
+/// changes: when it is drawn, only the texts whose string,
+/// style, color or transform have changed are copied again.
+/// Texts whose number of quads changed, or that moved to
+/// another font or character size, cause their group to be
+/// regenerated.
+///
+/// Within a group, texts are drawn in the order they were
+/// added; groups are drawn in the order they were created.
+/// The transform, blend mode and shader of the render states
+/// apply to all the texts.
+///
+/// Usage example:
+/// \code
+/// std::vector<sf::Text> labels = ...;
+/// sf::String score = ...;
+///
+/// sf::TextBatch batch;
+/// for (std::size_t i = 0; i < labels.size(); ++i)
+///     batch.add(labels[i]);
+///
+/// while (window.isOpen())
+/// {
+///     ...
+///
+///     labels[0].setString(score);
+///
+///     window.clear();
+///     window.draw(batch);
+///     window.display();
+/// }
+/// \endcode
+///
+/// \see sf::Text, sf::SpriteBatch
+///
+////////////////////////////////////////////////////////////
@@ -0,0 +1,249 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2012 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+#ifndef SFML_TEXTLAYOUT_HPP
+#define SFML_TEXTLAYOUT_HPP
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Graphics/Export.hpp>
+#include <SFML/System/Vector2.hpp>
+#include <SFML/System/String.hpp>
+#include <vector>
+
+
+namespace sf
+{
+class Font;
+
+////////////////////////////////////////////////////////////
+/// \brief Positions of the characters of a string, computed
+///        without producing any geometry
+///
+////////////////////////////////////////////////////////////
+class SFML_GRAPHICS_API TextLayout
+{
+public :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Default constructor
+    ///
+    /// Creates an empty layout, which is not bound to any font.
+    ///
+    ////////////////////////////////////////////////////////////
+    TextLayout();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Construct the layout of a string
+    ///
+    /// \param font          Font used to measure the characters
+    /// \param string        String to lay out
+    /// \param characterSize Character size, in pixels
+    /// \param bold          Use the metrics of the bold glyphs?
+    /// \param maxWidth      Maximum width of the lines, or 0 to disable line wrapping
+    ///
+    ////////////////////////////////////////////////////////////
+    TextLayout(const Font& font, const String& string, unsigned int characterSize, bool bold = false, float maxWidth = 0.f);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Remove all the characters and change the layout parameters
+    ///
+    /// \param font          Font used to measure the characters
+    /// \param characterSize Character size, in pixels
+    /// \param bold          Use the metrics of the bold glyphs?
+    /// \param maxWidth      Maximum width of the lines, or 0 to disable line wrapping
+    ///
+    ////////////////////////////////////////////////////////////
+    void reset(const Font& font, unsigned int characterSize, bool bold = false, float maxWidth = 0.f);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Remove all the characters from the layout
+    ///
+    /// The layout parameters are kept.
+    ///
+    ////////////////////////////////////////////////////////////
+    void clear();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Lay out the end of a string
+    ///
+    /// \a string must start with the characters that are already
+    /// laid out; only the following ones are added, from the
+    /// position where the previous ones stopped. This makes it
+    /// cheap to follow a string that grows.
+    /// This function does nothing if the layout is not bound
+    /// to a font.
+    ///
+    /// \param string String to lay out
+    ///
+    ////////////////////////////////////////////////////////////
+    void append(const String& string);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the number of characters that are laid out
+    ///
+    /// \return Number of characters
+    ///
+    ////////////////////////////////////////////////////////////
+    std::size_t getCharacterCount() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the position of a character
+    ///
+    /// The returned position is the one of the pen when the
+    /// character is drawn, kerning included; its vertical
+    /// coordinate is the top of the line, the baseline being
+    /// one character size below (like in sf::Text).
+    /// If \a index is out of range, the position of the pen
+    /// after the last character is returned.
+    ///
+    /// \param index Index of the character
+    ///
+    /// \return Position of the character
+    ///
+    ////////////////////////////////////////////////////////////
+    Vector2f getCharacterPosition(std::size_t index) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the horizontal advance of a character
+    ///
+    /// Line breaks have no advance.
+    /// This function doesn't check \a index, it must be in range
+    /// [0, getCharacterCount() - 1]. The behaviour is undefined
+    /// otherwise.
+    ///
+    /// \param index Index of the character
+    ///
+    /// \return Offset from the character to the next one
+    ///
+    ////////////////////////////////////////////////////////////
+    float getAdvance(std::size_t index) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the number of lines
+    ///
+    /// Lines are started by '\\n' characters and by line wrapping.
+    ///
+    /// \return Number of lines (at least 1)
+    ///
+    ////////////////////////////////////////////////////////////
+    std::size_t getLineCount() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the index of the first character of a line
+    ///
+    /// This function doesn't check \a line, it must be in range
+    /// [0, getLineCount() - 1]. The behaviour is undefined
+    /// otherwise.
+    ///
+    /// \param line Index of the line
+    ///
+    /// \return Index of the first character of the line
+    ///
+    ////////////////////////////////////////////////////////////
+    std::size_t getLineStart(std::size_t line) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the size of the laid out text
+    ///
+    /// The width is the one of the longest line, trailing
+    /// whitespaces excluded; the height covers all the lines,
+    /// according to the line spacing of the font.
+    ///
+    /// \return Size of the text
+    ///
+    ////////////////////////////////////////////////////////////
+    Vector2f getSize() const;
+
+private :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Move the end of the current line to a new line
+    ///
+    /// The line is broken after its last whitespace, or before
+    /// the current character if it has none.
+    ///
+    /// \param string  String being laid out
+    /// \param current Index of the character that doesn't fit in the line
+    ///
+    ////////////////////////////////////////////////////////////
+    void wrap(const String& string, std::size_t current);
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    const Font*              m_font;          ///< Font used to measure the characters
+    unsigned int             m_characterSize; ///< Character size, in pixels
+    bool                     m_bold;          ///< Use the metrics of the bold glyphs?
+    float                    m_maxWidth;      ///< Maximum width of the lines (0 if lines are not wrapped)
+    float                    m_spaceAdvance;  ///< Advance of the space character
+    float                    m_lineSpacing;   ///< Vertical offset between two lines
+    std::vector<Vector2f>    m_positions;     ///< Position of each character
+    std::vector<float>       m_advances;      ///< Advance of each character
+    std::vector<std::size_t> m_lineStarts;    ///< Index of the first character of each line
+    Vector2f                 m_pen;           ///< Position of the next character, before kerning
+    Uint32                   m_previousChar;  ///< Last character laid out, for kerning
+    std::size_t              m_breakPosition; ///< Index following the last whitespace of the current line, where it can be wrapped
+    float                    m_width;         ///< Width of the longest finished line
+    float                    m_lineWidth;     ///< Width of the current line
+};
+
+} // namespace sf
+
+
+#endif // SFML_TEXTLAYOUT_HPP
+
+
+////////////////////////////////////////////////////////////
+/// \class sf::TextLayout
+/// \ingroup graphics
+///
+/// sf::TextLayout computes where the characters of a string
+/// go, with the same rules as sf::Text (which uses it
+/// internally), but without building any vertex. It is meant
+/// for measuring and placing text in user interfaces: it
+/// provides the position and advance of every character, the
+/// size of the whole text and the lines, optionally wrapped
+/// to a maximum width.
+///
+/// Lines are wrapped after their last whitespace; a word that
+/// is longer than the maximum width is broken before the first
+/// character that doesn't fit.
+///
+/// sf::Font::getLayout returns cached layouts, so that the
+/// same string is measured only once.
+///
+/// Example:
+/// \code
+/// sf::TextLayout layout(font, "Hello, this is a long sentence", 20, false, 150);
+///
+/// sf::Vector2f size = layout.getSize();
+/// for (std::size_t i = 0; i < layout.getLineCount(); ++i)
+///     std::cout << "line " << i << " starts at character " << layout.getLineStart(i) << std::endl;
+/// \endcode
+///
+/// \see sf::Font, sf::Text
+///
+////////////////////////////////////////////////////////////
@@ -31,10 +31,16 @@
 #include <SFML/Graphics/Export.hpp>
 #include <SFML/Graphics/Image.hpp>
 #include <SFML/Window/GlResource.hpp>
+#include <vector>
 
 
 namespace sf
 {
+namespace priv
+{
+    class PixelBuffer;
+}
+
 class Window;
 class RenderTarget;
 class RenderTexture;
@@ -58,6 +64,16 @@ public :
         Pixels      ///< Texture coordinates in range [0 .. size]
     };
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Formats of the pixels stored in a texture
+    ///
+    ////////////////////////////////////////////////////////////
+    enum PixelFormat
+    {
+        Rgba, ///< 32-bits pixels, with red, green, blue and alpha components
+        Alpha ///< 8-bits pixels, with only an alpha component; the color is always white
+    };
+
 public :
 
     ////////////////////////////////////////////////////////////
@@ -85,15 +101,22 @@ public :
     ////////////////////////////////////////////////////////////
     /// \brief Create the texture
     ///
+    /// Alpha textures take 4 times less memory than RGBA ones,
+    /// which makes them the best choice for masks and glyphs.
+    /// If the system can't store single-channel textures that
+    /// are sampled as white, a luminance-alpha storage is used
+    /// instead; it is invisible to the user.
+    ///
     /// If this function fails, the texture is left unchanged.
     ///
     /// \param width  Width of the texture
     /// \param height Height of the texture
+    /// \param format Format of the pixels
     ///
     /// \return True if creation was successful
     ///
     ////////////////////////////////////////////////////////////
-    bool create(unsigned int width, unsigned int height);
+    bool create(unsigned int width, unsigned int height, PixelFormat format = Rgba);
 
     ////////////////////////////////////////////////////////////
     /// \brief Load the texture from a file on disk
@@ -221,6 +244,14 @@ public :
     ////////////////////////////////////////////////////////////
     Vector2u getSize() const;
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Return the format of the texture pixels
+    ///
+    /// \return Pixel format given to create
+    ///
+    ////////////////////////////////////////////////////////////
+    PixelFormat getPixelFormat() const;
+
     ////////////////////////////////////////////////////////////
     /// \brief Copy the texture pixels to an image
     ///
@@ -228,6 +259,7 @@ public :
     /// the texture's pixels from the graphics card and copies
     /// them to a new image, potentially applying transformations
     /// to pixels if necessary (texture may be padded or flipped).
+    /// The pixels of an alpha texture are returned as white.
     ///
     /// \return Image containing the texture's pixels
     ///
@@ -240,7 +272,8 @@ public :
     /// \brief Update the whole texture from an array of pixels
     ///
     /// The \a pixel array is assumed to have the same size as
-    /// the \a area rectangle, and to contain 32-bits RGBA pixels.
+    /// the \a area rectangle, and to contain pixels in the format
+    /// of the texture: 32-bits RGBA pixels, or 8-bits alpha values.
     ///
     /// No additional check is performed on the size of the pixel
     /// array, passing invalid arguments will lead to an undefined
@@ -258,7 +291,8 @@ public :
     /// \brief Update a part of the texture from an array of pixels
     ///
     /// The size of the \a pixel array must match the \a width and
-    /// \a height arguments, and it must contain 32-bits RGBA pixels.
+    /// \a height arguments, and it must contain pixels in the format
+    /// of the texture: 32-bits RGBA pixels, or 8-bits alpha values.
     ///
     /// No additional check is performed on the size of the pixel
     /// array or the bounds of the area to update, passing invalid
@@ -288,6 +322,9 @@ public :
     /// passing an image bigger than the texture will lead to an
     /// undefined behaviour.
     ///
+    /// Only the alpha component of the image pixels is kept
+    /// if the texture is an alpha texture.
+    ///
     /// This function does nothing if the texture was not
     /// previously created.
     ///
@@ -303,6 +340,9 @@ public :
     /// passing an invalid combination of image size and offset
     /// will lead to an undefined behaviour.
     ///
+    /// Only the alpha component of the image pixels is kept
+    /// if the texture is an alpha texture.
+    ///
     /// This function does nothing if the texture was not
     /// previously created.
     ///
@@ -328,6 +368,9 @@ public :
     /// This function does nothing if either the texture or the window
     /// was not previously created.
     ///
+    /// If the window is a sf::RenderWindow, its pending batched
+    /// and deferred primitives are rendered before the copy.
+    ///
     /// \param window Window to copy to the texture
     ///
     ////////////////////////////////////////////////////////////
@@ -350,6 +393,104 @@ public :
     ////////////////////////////////////////////////////////////
     void update(const Window& window, unsigned int x, unsigned int y);
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Copy pixels from another texture onto this one
+    ///
+    /// This function does a fast pixel copy directly on the
+    /// graphics card, the pixels are never transferred to the
+    /// system memory. If the system doesn't support frame
+    /// buffer objects, the copy goes through an image instead,
+    /// which is much slower.
+    ///
+    /// If \a sourceRect is empty, the whole texture is copied.
+    /// The copied area is clipped to the bounds of both textures.
+    /// The source can be this texture itself, in which case the
+    /// area is first copied to a temporary texture, so that it
+    /// can safely overlap the destination area.
+    ///
+    /// This function does nothing if either texture was not
+    /// previously created.
+    ///
+    /// \param source     Source texture to copy
+    /// \param destX      X coordinate of the destination position
+    /// \param destY      Y coordinate of the destination position
+    /// \param sourceRect Sub-rectangle of the source texture to copy
+    ///
+    ////////////////////////////////////////////////////////////
+    void copy(const Texture& source, unsigned int destX, unsigned int destY, const IntRect& sourceRect = IntRect(0, 0, 0, 0));
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Update a part of the texture from an array of pixels, asynchronously
+    ///
+    /// Unlike update, this function doesn't give the pixels to the
+    /// driver directly: they are first copied to a pixel buffer,
+    /// from which the graphics card transfers them to the texture
+    /// while the program goes on. This avoids stalling the program
+    /// when large images are uploaded while the texture is in use.
+    ///
+    /// The \a pixels array can be reused or destroyed as soon as
+    /// this function returns, and whatever is drawn with the texture
+    /// after this call shows the new pixels. The returned ticket
+    /// can be passed to isUpdateComplete to know when the transfer
+    /// is actually finished.
+    ///
+    /// The size of the \a pixel array must match the \a width and
+    /// \a height arguments, and it must contain pixels in the format
+    /// of the texture: 32-bits RGBA pixels, or 8-bits alpha values.
+    /// No additional check is performed on the size of the pixel
+    /// array or the bounds of the area to update, passing invalid
+    /// arguments will lead to an undefined behaviour.
+    ///
+    /// If the system doesn't support pixel buffers, the texture
+    /// is updated synchronously. This function does nothing if
+    /// \a pixels is null or if the texture was not previously created.
+    ///
+    /// \param pixels Array of pixels to copy to the texture
+    /// \param width  Width of the pixel region contained in \a pixels
+    /// \param height Height of the pixel region contained in \a pixels
+    /// \param x      X offset in the texture where to copy the source pixels
+    /// \param y      Y offset in the texture where to copy the source pixels
+    ///
+    /// \return Ticket identifying the transfer, or 0 if nothing was done
+    ///
+    /// \see isUpdateComplete
+    ///
+    ////////////////////////////////////////////////////////////
+    Uint64 updateAsync(const Uint8* pixels, unsigned int width, unsigned int height, unsigned int x, unsigned int y);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Update a part of the texture from an image, asynchronously
+    ///
+    /// See the other overload for the details.
+    ///
+    /// \param image Image to copy to the texture
+    /// \param x     X offset in the texture where to copy the source image
+    /// \param y     Y offset in the texture where to copy the source image
+    ///
+    /// \return Ticket identifying the transfer, or 0 if nothing was done
+    ///
+    /// \see isUpdateComplete
+    ///
+    ////////////////////////////////////////////////////////////
+    Uint64 updateAsync(const Image& image, unsigned int x, unsigned int y);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Tell whether an asynchronous update is finished
+    ///
+    /// This function never blocks. Asynchronous updates finish
+    /// in the order they were requested. If the system doesn't
+    /// support fences, updates are considered finished as soon
+    /// as they are requested.
+    ///
+    /// \param ticket Ticket returned by updateAsync
+    ///
+    /// \return True if the pixels have been transferred to the texture
+    ///
+    /// \see updateAsync
+    ///
+    ////////////////////////////////////////////////////////////
+    bool isUpdateComplete(Uint64 ticket) const;
+
     ////////////////////////////////////////////////////////////
     /// \brief Activate the texture for rendering
     ///
@@ -442,6 +583,18 @@ public :
     ////////////////////////////////////////////////////////////
     Texture& operator =(const Texture& right);
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Swap the contents of this texture with those of another
+    ///
+    /// This is a cheap operation: only the OpenGL identifiers
+    /// and the properties of the textures are exchanged, the
+    /// pixels are not copied.
+    ///
+    /// \param right Instance to swap with
+    ///
+    ////////////////////////////////////////////////////////////
+    void swap(Texture& right);
+
     ////////////////////////////////////////////////////////////
     /// \brief Get the maximum texture size allowed
     ///
@@ -458,6 +611,7 @@ private :
 
     friend class RenderTexture;
     friend class RenderTarget;
+    friend class ReadbackRequest;
 
     ////////////////////////////////////////////////////////////
     /// \brief Get a valid image size according to hardware support
@@ -474,16 +628,35 @@ private :
     ////////////////////////////////////////////////////////////
     static unsigned int getValidSize(unsigned int size);
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Copy pixels to the bound texture, converting them to its storage if needed
+    ///
+    /// The pixels must be in the format of the texture, and the area
+    /// must be expressed in the storage space (i.e. already flipped
+    /// if needed).
+    ///
+    /// \param pixels Array of pixels to copy to the texture
+    /// \param width  Width of the pixel region contained in \a pixels
+    /// \param height Height of the pixel region contained in \a pixels
+    /// \param x      X offset in the texture where to copy the source pixels
+    /// \param y      Y offset in the texture where to copy the source pixels
+    ///
+    ////////////////////////////////////////////////////////////
+    void uploadPixels(const Uint8* pixels, unsigned int width, unsigned int height, unsigned int x, unsigned int y);
+
     ////////////////////////////////////////////////////////////
     // Member data
     ////////////////////////////////////////////////////////////
-    Vector2u     m_size;          ///< Public texture size
-    Vector2u     m_actualSize;    ///< Actual texture size (can be greater than public size because of padding)
-    unsigned int m_texture;       ///< Internal texture identifier
-    bool         m_isSmooth;      ///< Status of the smooth filter
-    bool         m_isRepeated;    ///< Is the texture in repeat mode?
-    mutable bool m_pixelsFlipped; ///< To work around the inconsistency in Y orientation
-    Uint64       m_cacheId;       ///< Unique number that identifies the texture to the render target's cache
+    Vector2u                        m_size;          ///< Public texture size
+    Vector2u                        m_actualSize;    ///< Actual texture size (can be greater than public size because of padding)
+    unsigned int                    m_texture;       ///< Internal texture identifier
+    PixelFormat                     m_format;        ///< Format of the pixels
+    bool                            m_isSmooth;      ///< Status of the smooth filter
+    bool                            m_isRepeated;    ///< Is the texture in repeat mode?
+    mutable bool                    m_pixelsFlipped; ///< To work around the inconsistency in Y orientation
+    Uint64                          m_cacheId;       ///< Unique number that identifies the texture to the render target's cache
+    std::vector<priv::PixelBuffer*> m_uploadBuffers; ///< Ring of pixel buffers used by asynchronous updates
+    Uint64                          m_uploadCount;   ///< Number of asynchronous updates requested so far
 };
 
 } // namespace sf
@@ -526,6 +699,13 @@ private :
 /// store the collision information separately, for example in an array
 /// of booleans.
 ///
+/// Uploading a big chunk of pixels with Texture::update blocks
+/// the program until the driver has consumed them. When images
+/// are streamed in while the texture is being drawn, use
+/// Texture::updateAsync instead: the pixels are transferred by
+/// the graphics card in the background, and the returned ticket
+/// tells when the transfer is finished.
+///
 /// Like sf::Image, sf::Texture can handle a unique internal
 /// representation of pixels, which is RGBA 32 bits. This means
 /// that a pixel must be composed of 8 bits red, green, blue and
@@ -0,0 +1,365 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2012 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+#ifndef SFML_TEXTUREATLAS_HPP
+#define SFML_TEXTUREATLAS_HPP
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Graphics/Export.hpp>
+#include <SFML/Graphics/Image.hpp>
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/System/NonCopyable.hpp>
+#include <map>
+#include <vector>
+
+
+namespace sf
+{
+class Texture;
+
+////////////////////////////////////////////////////////////
+/// \brief Packs many images into a few big textures
+///
+////////////////////////////////////////////////////////////
+class SFML_GRAPHICS_API TextureAtlas : NonCopyable
+{
+public :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Default constructor
+    ///
+    /// Creates an empty atlas, with pages of 1024x1024 pixels.
+    ///
+    ////////////////////////////////////////////////////////////
+    TextureAtlas();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Construct an empty atlas with a given page size
+    ///
+    /// The page size is clamped to Texture::getMaximumSize().
+    ///
+    /// \param pageSize Width and height of the pages, in pixels
+    ///
+    ////////////////////////////////////////////////////////////
+    explicit TextureAtlas(unsigned int pageSize);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Destructor
+    ///
+    ////////////////////////////////////////////////////////////
+    ~TextureAtlas();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Add a whole image to the atlas
+    ///
+    /// The image is copied, so it can be destroyed after
+    /// this call.
+    ///
+    /// \param image Image to add
+    ///
+    /// \return Identifier of the new entry, or 0 on failure
+    ///
+    ////////////////////////////////////////////////////////////
+    unsigned int add(const Image& image);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Add a part of an image to the atlas
+    ///
+    /// If \a sourceRect is empty, the whole image is added.
+    /// The pixels are copied, so the image can be destroyed
+    /// after this call.
+    ///
+    /// \param image      Image to add
+    /// \param sourceRect Part of the image to add
+    ///
+    /// \return Identifier of the new entry, or 0 on failure
+    ///
+    ////////////////////////////////////////////////////////////
+    unsigned int add(const Image& image, const IntRect& sourceRect);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Remove an entry from the atlas
+    ///
+    /// The space used by the entry is not reused until
+    /// repack() is called.
+    ///
+    /// \param id Identifier of the entry to remove
+    ///
+    ////////////////////////////////////////////////////////////
+    void remove(unsigned int id);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Remove all the entries and pages
+    ///
+    ////////////////////////////////////////////////////////////
+    void clear();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Pack all the entries again, from scratch
+    ///
+    /// This reclaims the space left by removed entries, and
+    /// applies the current padding and extrusion to all the
+    /// entries. Entries are sorted by height before being
+    /// inserted, which usually gives a tighter packing than
+    /// incremental insertion. Unused pages are destroyed.
+    ///
+    /// The texture and texture rectangle of every entry may
+    /// change, so they must be retrieved again after this call.
+    ///
+    ////////////////////////////////////////////////////////////
+    void repack();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Tell whether an entry exists in the atlas
+    ///
+    /// \param id Identifier of the entry
+    ///
+    /// \return True if the entry exists
+    ///
+    ////////////////////////////////////////////////////////////
+    bool contains(unsigned int id) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the texture that contains an entry
+    ///
+    /// If \a id is not a valid entry, an empty texture
+    /// is returned.
+    ///
+    /// \param id Identifier of the entry
+    ///
+    /// \return Texture of the page that contains the entry
+    ///
+    ////////////////////////////////////////////////////////////
+    const Texture& getTexture(unsigned int id) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the area of its texture occupied by an entry
+    ///
+    /// The rectangle doesn't include the padding and
+    /// extrusion, it can be given directly to a sprite.
+    /// If \a id is not a valid entry, an empty rectangle
+    /// is returned.
+    ///
+    /// \param id Identifier of the entry
+    ///
+    /// \return Texture rectangle of the entry
+    ///
+    ////////////////////////////////////////////////////////////
+    IntRect getTextureRect(unsigned int id) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the number of pages (textures) of the atlas
+    ///
+    /// \return Number of pages
+    ///
+    ////////////////////////////////////////////////////////////
+    unsigned int getPageCount() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the texture of a page
+    ///
+    /// This function doesn't check \a index, it must be in range
+    /// [0, getPageCount() - 1]. The behaviour is undefined
+    /// otherwise.
+    ///
+    /// \param index Index of the page
+    ///
+    /// \return Texture of the page
+    ///
+    ////////////////////////////////////////////////////////////
+    const Texture& getPage(unsigned int index) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the size of the pages
+    ///
+    /// \return Width and height of the pages, in pixels
+    ///
+    ////////////////////////////////////////////////////////////
+    unsigned int getPageSize() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the fraction of the pages occupied by entries
+    ///
+    /// Only the pixels of the entries are counted, not their
+    /// padding and extrusion, nor the space left by removed
+    /// entries.
+    ///
+    /// \return Fill ratio, in range [0, 1]
+    ///
+    ////////////////////////////////////////////////////////////
+    float getFillRatio() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Set the number of empty pixels between entries
+    ///
+    /// The padding prevents the pixels of an entry from leaking
+    /// into its neighbours when the textures are smoothed or
+    /// mipmapped. It is applied to the entries added after this
+    /// call, and to all the entries after the next repack().
+    /// The default padding is 1 pixel.
+    ///
+    /// \param padding Space between entries, in pixels
+    ///
+    ////////////////////////////////////////////////////////////
+    void setPadding(unsigned int padding);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the number of empty pixels between entries
+    ///
+    /// \return Space between entries, in pixels
+    ///
+    ////////////////////////////////////////////////////////////
+    unsigned int getPadding() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Set the number of border pixels replicated around entries
+    ///
+    /// Extruding the border pixels of an entry avoids seams
+    /// when it is drawn with a smooth texture or at non-integer
+    /// positions, for example in tile maps. It is applied to
+    /// the entries added after this call, and to all the entries
+    /// after the next repack(). The default extrusion is 0.
+    ///
+    /// \param extrusion Number of border pixels to replicate
+    ///
+    ////////////////////////////////////////////////////////////
+    void setExtrusion(unsigned int extrusion);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the number of border pixels replicated around entries
+    ///
+    /// \return Number of replicated border pixels
+    ///
+    ////////////////////////////////////////////////////////////
+    unsigned int getExtrusion() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Enable or disable the smooth filter on the pages
+    ///
+    /// The smooth filter is disabled by default.
+    ///
+    /// \param smooth True to enable smoothing, false to disable it
+    ///
+    ////////////////////////////////////////////////////////////
+    void setSmooth(bool smooth);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Tell whether the smooth filter is enabled on the pages
+    ///
+    /// \return True if smoothing is enabled, false if it is disabled
+    ///
+    ////////////////////////////////////////////////////////////
+    bool isSmooth() const;
+
+private :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Page of the atlas (defined in the implementation)
+    ///
+    ////////////////////////////////////////////////////////////
+    struct Page;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Image stored in the atlas
+    ///
+    ////////////////////////////////////////////////////////////
+    struct Entry
+    {
+        Image        image;     ///< Copy of the pixels, kept for repacking
+        unsigned int page;      ///< Index of the page that contains the entry
+        IntRect      rect;      ///< Texture rectangle of the entry in its page
+    };
+
+    typedef std::map<unsigned int, Entry> EntryTable;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Find a place for an entry and upload its pixels
+    ///
+    /// \param entry Entry to insert, its page and rectangle are updated
+    ///
+    /// \return True on success, false if the entry is bigger than a page
+    ///
+    ////////////////////////////////////////////////////////////
+    bool insert(Entry& entry);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Create a new empty page
+    ///
+    /// \return Index of the new page
+    ///
+    ////////////////////////////////////////////////////////////
+    unsigned int createPage();
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    std::vector<Page*> m_pages;     ///< Pages of the atlas
+    EntryTable         m_entries;   ///< Entries of the atlas, by identifier
+    unsigned int       m_nextId;    ///< Identifier of the next added entry
+    unsigned int       m_pageSize;  ///< Width and height of the pages
+    unsigned int       m_padding;   ///< Space between entries
+    unsigned int       m_extrusion; ///< Number of replicated border pixels
+    bool               m_isSmooth;  ///< Status of the smooth filter
+};
+
+} // namespace sf
+
+
+#endif // SFML_TEXTUREATLAS_HPP
+
+
+////////////////////////////////////////////////////////////
+/// \class sf::TextureAtlas
+/// \ingroup graphics
+///
+/// Sprites that use different textures can't be drawn in the
+/// same batch. sf::TextureAtlas packs many small images into
+/// a few big textures ("pages"), so that the sprites that use
+/// them can share the same texture.
+///
+/// Every added image gets an identifier, which is used to
+/// retrieve the texture and the texture rectangle to give
+/// to a sprite. When an entry doesn't fit in the existing
+/// pages, a new page is created.
+///
+/// Removing an entry doesn't free its space immediately;
+/// call repack() after a batch of removals to reclaim it.
+/// Since the atlas keeps a copy of the pixels of every
+/// entry, repacking doesn't need the original images.
+///
+/// Example:
+/// \code
+/// sf::TextureAtlas atlas;
+/// unsigned int hero = atlas.add(heroImage);
+/// unsigned int coin = atlas.add(itemsImage, sf::IntRect(0, 0, 16, 16));
+///
+/// sf::Sprite sprite(atlas.getTexture(hero), atlas.getTextureRect(hero));
+/// \endcode
+///
+/// \see sf::Texture, sf::Image, sf::Sprite
+///
+////////////////////////////////////////////////////////////
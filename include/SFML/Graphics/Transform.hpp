@@ -31,10 +31,13 @@
 #include <SFML/Graphics/Export.hpp>
 #include <SFML/Graphics/Rect.hpp>
 #include <SFML/System/Vector2.hpp>
+#include <cstddef>
 
 
 namespace sf
 {
+class Vertex;
+
 ////////////////////////////////////////////////////////////
 /// \brief Define a 3x3 transform matrix
 ///
@@ -118,6 +121,38 @@ public :
     ////////////////////////////////////////////////////////////
     Vector2f transformPoint(const Vector2f& point) const;
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Transform an array of 2D points
+    ///
+    /// This function gives the same results as calling
+    /// transformPoint on each point, but it is much faster
+    /// for large arrays since it processes several points
+    /// at once when the processor allows it (SSE2).
+    /// \a points and \a result can be the same array, but
+    /// they must not partially overlap.
+    ///
+    /// \param points Array of points to transform
+    /// \param result Array that receives the transformed points
+    /// \param count  Number of points in the arrays
+    ///
+    ////////////////////////////////////////////////////////////
+    void transformPoints(const Vector2f* points, Vector2f* result, std::size_t count) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Transform the positions of an array of vertices
+    ///
+    /// The position of each vertex is transformed, its color
+    /// and texture coordinates are copied unchanged.
+    /// \a vertices and \a result can be the same array, but
+    /// they must not partially overlap.
+    ///
+    /// \param vertices Array of vertices to transform
+    /// \param result   Array that receives the transformed vertices
+    /// \param count    Number of vertices in the arrays
+    ///
+    ////////////////////////////////////////////////////////////
+    void transformPoints(const Vertex* vertices, Vertex* result, std::size_t count) const;
+
     ////////////////////////////////////////////////////////////
     /// \brief Transform a rectangle
     ///
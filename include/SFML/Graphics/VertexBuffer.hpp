@@ -0,0 +1,266 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2012 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+#ifndef SFML_VERTEXBUFFER_HPP
+#define SFML_VERTEXBUFFER_HPP
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Graphics/Export.hpp>
+#include <SFML/Graphics/Vertex.hpp>
+#include <SFML/Graphics/PrimitiveType.hpp>
+#include <SFML/Graphics/Drawable.hpp>
+#include <SFML/Window/GlResource.hpp>
+#include <SFML/System/NonCopyable.hpp>
+
+
+namespace sf
+{
+////////////////////////////////////////////////////////////
+/// \brief Set of 2D primitives stored in the graphics card memory
+///
+////////////////////////////////////////////////////////////
+class SFML_GRAPHICS_API VertexBuffer : public Drawable, GlResource, NonCopyable
+{
+public :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Usage hints for the vertex buffer
+    ///
+    /// They tell the driver how often the contents of the
+    /// buffer are going to be updated, so that it can store
+    /// them in the most appropriate memory.
+    ///
+    ////////////////////////////////////////////////////////////
+    enum Usage
+    {
+        Stream,  ///< Contents are updated every time they are drawn
+        Dynamic, ///< Contents are updated often, and drawn several times between updates
+        Static   ///< Contents are updated rarely, or never
+    };
+
+public :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Default constructor
+    ///
+    /// Creates an empty vertex buffer, with the sf::Points
+    /// primitive type and the Stream usage.
+    ///
+    ////////////////////////////////////////////////////////////
+    VertexBuffer();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Construct the vertex buffer with a type and a usage
+    ///
+    /// \param type  Type of primitives
+    /// \param usage Usage hint of the buffer
+    ///
+    ////////////////////////////////////////////////////////////
+    explicit VertexBuffer(PrimitiveType type, Usage usage = Stream);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Destructor
+    ///
+    ////////////////////////////////////////////////////////////
+    ~VertexBuffer();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Allocate the buffer
+    ///
+    /// The buffer is allocated in the graphics card memory with
+    /// room for \a vertexCount vertices, its contents are left
+    /// undefined until update() is called.
+    /// If the buffer was already created, its previous contents
+    /// are lost.
+    ///
+    /// \param vertexCount Number of vertices that the buffer can hold
+    ///
+    /// \return True if creation was successful
+    ///
+    ////////////////////////////////////////////////////////////
+    bool create(unsigned int vertexCount);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Return the vertex count
+    ///
+    /// \return Number of vertices that the buffer holds
+    ///
+    ////////////////////////////////////////////////////////////
+    unsigned int getVertexCount() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Update the whole buffer from an array of vertices
+    ///
+    /// The \a vertices array is assumed to contain getVertexCount()
+    /// elements. The previous storage of the buffer is orphaned,
+    /// so that the driver doesn't have to wait until the GPU has
+    /// finished drawing the previous contents.
+    ///
+    /// \param vertices Array of vertices to copy to the buffer
+    ///
+    /// \return True if the update was successful
+    ///
+    ////////////////////////////////////////////////////////////
+    bool update(const Vertex* vertices);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Update a part of the buffer from an array of vertices
+    ///
+    /// \a offset is the index of the first vertex to update.
+    /// If \a offset is 0 and \a vertexCount covers the whole
+    /// buffer (or more), the buffer is re-allocated (orphaned)
+    /// with the new size; otherwise the range defined by
+    /// \a offset and \a vertexCount must lie inside the buffer.
+    ///
+    /// \param vertices    Array of vertices to copy to the buffer
+    /// \param vertexCount Number of vertices to copy
+    /// \param offset      Index of the first vertex to update
+    ///
+    /// \return True if the update was successful
+    ///
+    ////////////////////////////////////////////////////////////
+    bool update(const Vertex* vertices, unsigned int vertexCount, unsigned int offset);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Set the type of primitives to draw
+    ///
+    /// The default primitive type is sf::Points.
+    ///
+    /// \param type Type of primitive
+    ///
+    ////////////////////////////////////////////////////////////
+    void setPrimitiveType(PrimitiveType type);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the type of primitives drawn by the vertex buffer
+    ///
+    /// \return Primitive type
+    ///
+    ////////////////////////////////////////////////////////////
+    PrimitiveType getPrimitiveType() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Set the usage hint of the vertex buffer
+    ///
+    /// The new usage is taken in account the next time
+    /// the buffer storage is (re-)allocated.
+    /// The default usage is Stream.
+    ///
+    /// \param usage Usage hint
+    ///
+    ////////////////////////////////////////////////////////////
+    void setUsage(Usage usage);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the usage hint of the vertex buffer
+    ///
+    /// \return Usage hint
+    ///
+    ////////////////////////////////////////////////////////////
+    Usage getUsage() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the OpenGL identifier of the buffer
+    ///
+    /// \return OpenGL name of the buffer, or 0 if not created yet
+    ///
+    ////////////////////////////////////////////////////////////
+    unsigned int getNativeHandle() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Tell whether or not the system supports vertex buffers
+    ///
+    /// This function should always be called before using
+    /// the vertex buffer features. If it returns false, then
+    /// any attempt to use sf::VertexBuffer will fail.
+    ///
+    /// \return True if vertex buffers are supported, false otherwise
+    ///
+    ////////////////////////////////////////////////////////////
+    static bool isAvailable();
+
+private :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Draw the vertex buffer to a render target
+    ///
+    /// \param target Render target to draw to
+    /// \param states Current render states
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual void draw(RenderTarget& target, RenderStates states) const;
+
+private :
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    unsigned int  m_buffer;        ///< OpenGL identifier of the buffer
+    unsigned int  m_size;          ///< Number of vertices in the buffer
+    PrimitiveType m_primitiveType; ///< Type of primitives to draw
+    Usage         m_usage;         ///< Usage hint of the buffer
+};
+
+} // namespace sf
+
+
+#endif // SFML_VERTEXBUFFER_HPP
+
+
+////////////////////////////////////////////////////////////
+/// \class sf::VertexBuffer
+/// \ingroup graphics
+///
+/// sf::VertexBuffer is similar to sf::VertexArray, except that
+/// its vertices live in the graphics card memory instead of
+/// the system memory. Once uploaded, they don't have to be sent
+/// again to the graphics card every time they are drawn, which
+/// makes vertex buffers the best choice for large and static
+/// geometry, like the tiles of a level.
+///
+/// The usage hint (Stream, Dynamic or Static) tells the driver
+/// how often the contents are going to change. Parts of the
+/// buffer can be modified with the update function.
+///
+/// Like sf::VertexArray, sf::VertexBuffer is not transformable,
+/// the transform is given in the render states when it is drawn.
+///
+/// Example:
+/// \code
+/// std::vector<sf::Vertex> tiles = ...;
+///
+/// sf::VertexBuffer buffer(sf::Quads, sf::VertexBuffer::Static);
+/// buffer.create(tiles.size());
+/// buffer.update(&tiles[0]);
+///
+/// ...
+///
+/// window.draw(buffer, &tileset);
+/// \endcode
+///
+/// \see sf::VertexArray, sf::Vertex
+///
+////////////////////////////////////////////////////////////
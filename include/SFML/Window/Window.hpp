@@ -407,6 +407,17 @@ protected :
     ////////////////////////////////////////////////////////////
     virtual void onResize();
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Function called before the window contents are displayed
+    ///
+    /// This function is called by display() so that derived
+    /// classes can finish their rendering (for example, render
+    /// primitives that they have delayed) before the contents
+    /// are shown on screen.
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual void onDisplay();
+
 private:
 
     ////////////////////////////////////////////////////////////
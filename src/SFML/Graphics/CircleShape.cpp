@@ -81,4 +81,12 @@ Vector2f CircleShape::getPoint(unsigned int index) const
     return Vector2f(m_radius + x, m_radius + y);
 }
 
+
+////////////////////////////////////////////////////////////
+bool CircleShape::getGeometryParameters(Vector2f& parameters) const
+{
+    parameters = Vector2f(m_radius, 0);
+    return true;
+}
+
 } // namespace sf
@@ -26,13 +26,20 @@
 // Headers
 ////////////////////////////////////////////////////////////
 #include <SFML/Graphics/Font.hpp>
+#include <SFML/Graphics/SkylinePacker.hpp>
+#include <SFML/Graphics/Shader.hpp>
 #include <SFML/System/InputStream.hpp>
+#include <SFML/System/Thread.hpp>
+#include <SFML/System/Mutex.hpp>
+#include <SFML/System/Lock.hpp>
 #include <SFML/System/Err.hpp>
 #include <ft2build.h>
 #include FT_FREETYPE_H
 #include FT_GLYPH_H
 #include FT_OUTLINE_H
 #include FT_BITMAP_H
+#include <algorithm>
+#include <cmath>
 #include <cstdlib>
 #include <cstring>
 
@@ -56,17 +63,455 @@ namespace
     void close(FT_Stream)
     {
     }
+
+    // Maximum number of threads used to rasterize the glyphs of a preload
+    const std::size_t preloadThreadCount = 4;
+
+    // Minimum number of glyphs rasterized by each of these threads,
+    // creating a FreeType face for fewer glyphs is not worth it
+    const std::size_t preloadGlyphsPerThread = 16;
+
+    // FreeType library shared by all the fonts; faces can be used by different
+    // threads, but creating and destroying them must be serialized
+    sf::Mutex    libraryMutex;
+    FT_Library   sharedLibrary = NULL;
+    unsigned int libraryUsers  = 0;
+
+    FT_Library acquireLibrary()
+    {
+        sf::Lock lock(libraryMutex);
+
+        if (!sharedLibrary && (FT_Init_FreeType(&sharedLibrary) != 0))
+        {
+            sharedLibrary = NULL;
+            return NULL;
+        }
+
+        ++libraryUsers;
+        return sharedLibrary;
+    }
+
+    void releaseLibrary()
+    {
+        sf::Lock lock(libraryMutex);
+
+        if (--libraryUsers == 0)
+        {
+            FT_Done_FreeType(sharedLibrary);
+            sharedLibrary = NULL;
+        }
+    }
+
+    // Character size at which the glyphs of distance field fonts are rasterized
+    const unsigned int distanceFieldSize = 64;
+
+    // Maximum distance to the outline stored around the glyphs of distance field fonts, in pixels
+    const unsigned int distanceFieldSpread = 8;
+
+    // Key of the page shared by all the character sizes in distance field mode (0 is not a valid size)
+    const unsigned int distanceFieldPage = 0;
+
+    // Fragment shader that turns distances back into sharp, antialiased edges;
+    // the edge is where the distance is 0.5, and it is smoothed over about one pixel on screen
+    const char distanceFieldShaderSource[] =
+        "uniform sampler2D texture;"
+        "void main()"
+        "{"
+        "    float distance = texture2D(texture, gl_TexCoord[0].xy).a;"
+        "    float smoothing = max(0.7 * fwidth(distance), 0.001);"
+        "    float alpha = smoothstep(0.5 - smoothing, 0.5 + smoothing, distance);"
+        "    gl_FragColor = vec4(gl_Color.rgb, gl_Color.a * alpha);"
+        "}";
+
+    // The distance field shader is shared by all the fonts that use it,
+    // and destroyed with the last one (it's a graphics resource, it can't be a global)
+    sf::Mutex    distanceFieldMutex;
+    sf::Shader*  distanceFieldShader      = NULL;
+    bool         distanceFieldShaderError = false;
+    unsigned int distanceFieldUsers       = 0;
+
+    void acquireDistanceFieldShader()
+    {
+        sf::Lock lock(distanceFieldMutex);
+        ++distanceFieldUsers;
+    }
+
+    void releaseDistanceFieldShader()
+    {
+        sf::Lock lock(distanceFieldMutex);
+        if (--distanceFieldUsers == 0)
+        {
+            delete distanceFieldShader;
+            distanceFieldShader      = NULL;
+            distanceFieldShaderError = false;
+        }
+    }
+
+    const sf::Shader* getDistanceFieldShader()
+    {
+        sf::Lock lock(distanceFieldMutex);
+
+        // Create the shader on first use, once
+        if (!distanceFieldShader && !distanceFieldShaderError && sf::Shader::isAvailable())
+        {
+            distanceFieldShader = new sf::Shader;
+            if (distanceFieldShader->loadFromMemory(distanceFieldShaderSource, sf::Shader::Fragment))
+            {
+                distanceFieldShader->setParameter("texture", sf::Shader::CurrentTexture);
+            }
+            else
+            {
+                delete distanceFieldShader;
+                distanceFieldShader      = NULL;
+                distanceFieldShaderError = true;
+            }
+        }
+
+        return distanceFieldShader;
+    }
+
+    // Scale a glyph of the distance field reference size to another character size
+    sf::Glyph scaleGlyph(const sf::Glyph& reference, unsigned int characterSize)
+    {
+        float scale = static_cast<float>(characterSize) / distanceFieldSize;
+
+        int left   = static_cast<int>(std::floor(reference.bounds.left * scale + 0.5f));
+        int top    = static_cast<int>(std::floor(reference.bounds.top * scale + 0.5f));
+        int right  = static_cast<int>(std::floor((reference.bounds.left + reference.bounds.width) * scale + 0.5f));
+        int bottom = static_cast<int>(std::floor((reference.bounds.top + reference.bounds.height) * scale + 0.5f));
+
+        sf::Glyph glyph;
+        glyph.advance     = static_cast<int>(std::floor(reference.advance * scale + 0.5f));
+        glyph.bounds      = sf::IntRect(left, top, right - left, bottom - top);
+        glyph.textureRect = reference.textureRect;
+
+        return glyph;
+    }
+
+    // One-dimensional squared Euclidean distance transform of a sampled function
+    // (P. Felzenszwalb and D. Huttenlocher, "Distance Transforms of Sampled Functions")
+    void distanceTransform(const float* f, float* d, int* v, float* z, int n)
+    {
+        int k = 0;
+        v[0] = 0;
+        z[0] = -1e20f;
+        z[1] = 1e20f;
+        for (int q = 1; q < n; ++q)
+        {
+            float s = ((f[q] + q * q) - (f[v[k]] + v[k] * v[k])) / (2 * q - 2 * v[k]);
+            while (s <= z[k])
+            {
+                --k;
+                s = ((f[q] + q * q) - (f[v[k]] + v[k] * v[k])) / (2 * q - 2 * v[k]);
+            }
+            ++k;
+            v[k] = q;
+            z[k] = s;
+            z[k + 1] = 1e20f;
+        }
+
+        k = 0;
+        for (int q = 0; q < n; ++q)
+        {
+            while (z[k + 1] < q)
+                ++k;
+            d[q] = (q - v[k]) * (q - v[k]) + f[v[k]];
+        }
+    }
+
+    // Two-dimensional version: replaces each value with the squared distance
+    // to the nearest zero value of the grid
+    void distanceTransform(std::vector<float>& grid, int width, int height)
+    {
+        int size = std::max(width, height);
+        std::vector<float> f(size);
+        std::vector<float> d(size);
+        std::vector<float> z(size + 1);
+        std::vector<int>   v(size);
+
+        // Transform the columns, then the rows
+        for (int x = 0; x < width; ++x)
+        {
+            for (int y = 0; y < height; ++y)
+                f[y] = grid[y * width + x];
+            distanceTransform(&f[0], &d[0], &v[0], &z[0], height);
+            for (int y = 0; y < height; ++y)
+                grid[y * width + x] = d[y];
+        }
+        for (int y = 0; y < height; ++y)
+        {
+            distanceTransform(&grid[y * width], &d[0], &v[0], &z[0], width);
+            std::copy(d.begin(), d.begin() + width, grid.begin() + y * width);
+        }
+    }
+
+    // Open-addressed hash table with linear probing, for integer keys;
+    // the key with all bits set marks empty slots, so it is stored aside
+    template <typename Key, typename Value>
+    class FlatHashMap
+    {
+    public :
+
+        FlatHashMap() : m_count(0), m_hasEmptyKey(false), m_emptyKeyValue() {}
+
+        const Value* find(Key key) const
+        {
+            if (key == empty())
+                return m_hasEmptyKey ? &m_emptyKeyValue : NULL;
+
+            if (m_keys.empty())
+                return NULL;
+
+            std::size_t mask = m_keys.size() - 1;
+            for (std::size_t i = hash(key) & mask; ; i = (i + 1) & mask)
+            {
+                if (m_keys[i] == key)
+                    return &m_values[i];
+                else if (m_keys[i] == empty())
+                    return NULL;
+            }
+        }
+
+        void insert(Key key, const Value& value)
+        {
+            if (key == empty())
+            {
+                m_hasEmptyKey   = true;
+                m_emptyKeyValue = value;
+                return;
+            }
+
+            // Keep the table at most half full, so that probe sequences remain short
+            if ((m_count + 1) * 2 > m_keys.size())
+            {
+                std::vector<Key> keys(m_keys.empty() ? 64 : m_keys.size() * 2, empty());
+                std::vector<Value> values(keys.size());
+                keys.swap(m_keys);
+                values.swap(m_values);
+                m_count = 0;
+                for (std::size_t i = 0; i < keys.size(); ++i)
+                {
+                    if (keys[i] != empty())
+                        insert(keys[i], values[i]);
+                }
+            }
+
+            std::size_t mask = m_keys.size() - 1;
+            std::size_t i = hash(key) & mask;
+            while ((m_keys[i] != empty()) && (m_keys[i] != key))
+                i = (i + 1) & mask;
+
+            if (m_keys[i] == empty())
+                m_count++;
+            m_keys[i]   = key;
+            m_values[i] = value;
+        }
+
+    private :
+
+        static Key empty()
+        {
+            return static_cast<Key>(-1);
+        }
+
+        static std::size_t hash(Key key)
+        {
+            // Fold the key to 32 bits, then mix it so that consecutive code points spread over the table
+            sf::Uint64 value = key;
+            sf::Uint32 h = static_cast<sf::Uint32>(value ^ (value >> 32)) * 2654435761u;
+            return h ^ (h >> 16);
+        }
+
+        std::vector<Key>   m_keys;
+        std::vector<Value> m_values;
+        std::size_t        m_count;
+        bool               m_hasEmptyKey;
+        Value              m_emptyKeyValue;
+    };
+
+    // Order in which preloaded glyphs are packed: tallest first
+    template <typename T>
+    struct BitmapHeightGreater
+    {
+        BitmapHeightGreater(const std::vector<T>& bitmaps) : m_bitmaps(bitmaps) {}
+
+        bool operator ()(std::size_t left, std::size_t right) const
+        {
+            return m_bitmaps[left].height > m_bitmaps[right].height;
+        }
+
+        const std::vector<T>& m_bitmaps;
+    };
+
+    // Maximum number of layouts cached by a font; the cache is emptied when it is full
+    const std::size_t maxCachedLayouts = 256;
+
+    // Add a 32-bits value to a hash (64-bits FNV-1a)
+    sf::Uint64 hashValue(sf::Uint64 hash, sf::Uint32 value)
+    {
+        for (int i = 0; i < 4; ++i)
+        {
+            hash ^= (value >> (i * 8)) & 0xFF;
+            hash *= 1099511628211ULL;
+        }
+
+        return hash;
+    }
+
+    // Add a float to a hash, using its bit pattern
+    sf::Uint64 hashValue(sf::Uint64 hash, float value)
+    {
+        sf::Uint32 bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return hashValue(hash, bits);
+    }
 }
 
 
 namespace sf
 {
+////////////////////////////////////////////////////////////
+struct Font::GlyphBitmap
+{
+    GlyphBitmap() : advance(0), left(0), top(0), width(0), height(0) {}
+
+    int                advance; ///< Offset to move horizontally to the next character
+    int                left;    ///< Horizontal offset of the bitmap from the pen position
+    int                top;     ///< Vertical offset of the bitmap from the baseline, upwards
+    unsigned int       width;   ///< Width of the bitmap, in pixels
+    unsigned int       height;  ///< Height of the bitmap, in pixels
+    std::vector<Uint8> pixels;  ///< Coverage of the pixels, 8 bits per pixel
+};
+
+
+////////////////////////////////////////////////////////////
+struct Font::Preload
+{
+    Preload() : fileData(NULL), fileSize(0), characterSize(0), bold(false), distanceField(false), next(0), finished(false), thread(NULL) {}
+    ~Preload() {delete thread;}
+
+    void run();
+    void work();
+
+    std::string              fileName;      ///< Path of the font file
+    const void*              fileData;      ///< Contents of the font file, if loaded from memory
+    std::size_t              fileSize;      ///< Size of the font file, if loaded from memory
+    unsigned int             characterSize; ///< Character size of the glyphs to rasterize
+    bool                     bold;          ///< Rasterize the bold version of the glyphs?
+    bool                     distanceField; ///< Convert the glyphs to distance fields?
+    std::vector<Uint32>      codePoints;    ///< Code points of the glyphs to rasterize
+    std::vector<GlyphBitmap> bitmaps;       ///< Rasterized glyphs, in the same order as the code points
+    std::vector<Uint8>       loaded;        ///< Tells which glyphs could be rasterized
+    std::size_t              next;          ///< Index of the next code point to rasterize
+    Mutex                    mutex;         ///< Mutex protecting next and finished
+    bool                     finished;      ///< Are all the glyphs rasterized?
+    Thread*                  thread;        ///< Thread running the preload in the background, if any
+};
+
+
+////////////////////////////////////////////////////////////
+void Font::Preload::run()
+{
+    // Start the workers; there's no point in having threads with only a few glyphs to rasterize
+    std::size_t count = (codePoints.size() + preloadGlyphsPerThread - 1) / preloadGlyphsPerThread;
+    count = std::max<std::size_t>(1, std::min(count, preloadThreadCount));
+
+    std::vector<Thread*> workers;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        workers.push_back(new Thread(&Preload::work, this));
+        workers.back()->launch();
+    }
+
+    // Wait for all of them to finish
+    for (std::vector<Thread*>::iterator it = workers.begin(); it != workers.end(); ++it)
+        delete *it;
+
+    Lock lock(mutex);
+    finished = true;
+}
+
+
+////////////////////////////////////////////////////////////
+void Font::Preload::work()
+{
+    // A face can't be used by several threads at the same time: each worker opens its own
+    FT_Library library = acquireLibrary();
+    if (!library)
+        return;
+
+    FT_Face face;
+    FT_Error error;
+    {
+        sf::Lock lock(libraryMutex);
+        error = fileData ? FT_New_Memory_Face(library, static_cast<const FT_Byte*>(fileData), static_cast<FT_Long>(fileSize), 0, &face)
+                         : FT_New_Face(library, fileName.c_str(), 0, &face);
+    }
+    if (error == 0)
+    {
+        if ((FT_Select_Charmap(face, FT_ENCODING_UNICODE) == 0) && (FT_Set_Pixel_Sizes(face, 0, characterSize) == 0))
+        {
+            // Rasterize glyphs until there are no more left
+            while (true)
+            {
+                std::size_t index;
+                {
+                    Lock lock(mutex);
+                    index = next++;
+                }
+
+                if (index >= codePoints.size())
+                    break;
+
+                loaded[index] = rasterizeGlyph(library, face, codePoints[index], bold, bitmaps[index]) ? 1 : 0;
+                if (loaded[index] && distanceField)
+                    makeDistanceField(bitmaps[index]);
+            }
+        }
+
+        sf::Lock lock(libraryMutex);
+        FT_Done_Face(face);
+    }
+
+    releaseLibrary();
+}
+
+
+////////////////////////////////////////////////////////////
+struct Font::SizeCache
+{
+    SizeCache() : lineSpacing(0), hasLineSpacing(false) {}
+
+    FlatHashMap<Uint32, const Glyph*> glyphs;         ///< Glyphs by key (code point and bold flag); they point into the glyph tables
+    FlatHashMap<Uint64, int>          kernings;       ///< Kerning offsets by pair of code points
+    int                               lineSpacing;    ///< Line spacing, if already known
+    bool                              hasLineSpacing; ///< Is the line spacing known?
+};
+
+
+////////////////////////////////////////////////////////////
+struct Font::CachedLayout
+{
+    String       string;        ///< String that was laid out
+    unsigned int characterSize; ///< Character size of the layout
+    bool         bold;          ///< Was the layout computed with the bold glyphs?
+    float        maxWidth;      ///< Maximum width of the lines
+    TextLayout   layout;        ///< Resulting layout
+};
+
+
 ////////////////////////////////////////////////////////////
 Font::Font() :
-m_library  (NULL),
-m_face     (NULL),
-m_streamRec(NULL),
-m_refCount (NULL)
+m_library      (NULL),
+m_face         (NULL),
+m_streamRec    (NULL),
+m_refCount     (NULL),
+m_fileData     (NULL),
+m_fileSize     (0),
+m_distanceField(false),
+m_lastSize     (0),
+m_lastCache    (NULL),
+m_layouts      ()
 {
 
 }
@@ -74,18 +519,32 @@ m_refCount (NULL)
 
 ////////////////////////////////////////////////////////////
 Font::Font(const Font& copy) :
-m_library    (copy.m_library),
-m_face       (copy.m_face),
-m_streamRec  (copy.m_streamRec),
-m_refCount   (copy.m_refCount),
-m_pages      (copy.m_pages),
-m_pixelBuffer(copy.m_pixelBuffer)
+m_library      (copy.m_library),
+m_face         (copy.m_face),
+m_streamRec    (copy.m_streamRec),
+m_refCount     (copy.m_refCount),
+m_pages        (copy.m_pages),
+m_fileName     (copy.m_fileName),
+m_fileData     (copy.m_fileData),
+m_fileSize     (copy.m_fileSize),
+m_distanceField(copy.m_distanceField),
+m_scaledGlyphs (copy.m_scaledGlyphs),
+m_sizeCaches   (),
+m_lastSize     (0),
+m_lastCache    (NULL),
+m_layouts      ()
 {
     // Note: as FreeType doesn't provide functions for copying/cloning,
     // we must share all the FreeType pointers
 
     if (m_refCount)
         (*m_refCount)++;
+
+    if (m_distanceField)
+        acquireDistanceFieldShader();
+
+    // The lookup tables and layouts are not copied, they would point to the
+    // other instance; they are rebuilt as the glyphs are requested
 }
 
 
@@ -93,6 +552,9 @@ m_pixelBuffer(copy.m_pixelBuffer)
 Font::~Font()
 {
     cleanup();
+
+    if (m_distanceField)
+        releaseDistanceFieldShader();
 }
 
 
@@ -103,11 +565,11 @@ bool Font::loadFromFile(const std::string& filename)
     cleanup();
     m_refCount = new int(1);
 
-    // Initialize FreeType
-    // Note: we initialize FreeType for every font instance in order to avoid having a single
-    // global manager that would create a lot of issues regarding creation and destruction order.
-    FT_Library library;
-    if (FT_Init_FreeType(&library) != 0)
+    // Get the FreeType library shared by all the fonts
+    // Note: it is reference-counted rather than global, so that it is created and
+    // destroyed with the fonts, and not at an undefined time of the program
+    FT_Library library = acquireLibrary();
+    if (!library)
     {
         err() << "Failed to load font \"" << filename << "\" (failed to initialize FreeType)" << std::endl;
         return false;
@@ -116,7 +578,12 @@ bool Font::loadFromFile(const std::string& filename)
 
     // Load the new font face from the specified file
     FT_Face face;
-    if (FT_New_Face(static_cast<FT_Library>(m_library), filename.c_str(), 0, &face) != 0)
+    FT_Error error;
+    {
+        sf::Lock lock(libraryMutex);
+        error = FT_New_Face(static_cast<FT_Library>(m_library), filename.c_str(), 0, &face);
+    }
+    if (error != 0)
     {
         err() << "Failed to load font \"" << filename << "\" (failed to create the font face)" << std::endl;
         return false;
@@ -132,6 +599,9 @@ bool Font::loadFromFile(const std::string& filename)
     // Store the loaded font in our ugly void* :)
     m_face = face;
 
+    // Keep the path, so that preload threads can open their own face
+    m_fileName = filename;
+
     return true;
 }
 
@@ -143,11 +613,11 @@ bool Font::loadFromMemory(const void* data, std::size_t sizeInBytes)
     cleanup();
     m_refCount = new int(1);
 
-    // Initialize FreeType
-    // Note: we initialize FreeType for every font instance in order to avoid having a single
-    // global manager that would create a lot of issues regarding creation and destruction order.
-    FT_Library library;
-    if (FT_Init_FreeType(&library) != 0)
+    // Get the FreeType library shared by all the fonts
+    // Note: it is reference-counted rather than global, so that it is created and
+    // destroyed with the fonts, and not at an undefined time of the program
+    FT_Library library = acquireLibrary();
+    if (!library)
     {
         err() << "Failed to load font from memory (failed to initialize FreeType)" << std::endl;
         return false;
@@ -156,7 +626,12 @@ bool Font::loadFromMemory(const void* data, std::size_t sizeInBytes)
 
     // Load the new font face from the specified file
     FT_Face face;
-    if (FT_New_Memory_Face(static_cast<FT_Library>(m_library), reinterpret_cast<const FT_Byte*>(data), static_cast<FT_Long>(sizeInBytes), 0, &face) != 0)
+    FT_Error error;
+    {
+        sf::Lock lock(libraryMutex);
+        error = FT_New_Memory_Face(static_cast<FT_Library>(m_library), reinterpret_cast<const FT_Byte*>(data), static_cast<FT_Long>(sizeInBytes), 0, &face);
+    }
+    if (error != 0)
     {
         err() << "Failed to load font from memory (failed to create the font face)" << std::endl;
         return false;
@@ -172,6 +647,10 @@ bool Font::loadFromMemory(const void* data, std::size_t sizeInBytes)
     // Store the loaded font in our ugly void* :)
     m_face = face;
 
+    // Keep the data, so that preload threads can open their own face
+    m_fileData = data;
+    m_fileSize = sizeInBytes;
+
     return true;
 }
 
@@ -183,11 +662,11 @@ bool Font::loadFromStream(InputStream& stream)
     cleanup();
     m_refCount = new int(1);
 
-    // Initialize FreeType
-    // Note: we initialize FreeType for every font instance in order to avoid having a single
-    // global manager that would create a lot of issues regarding creation and destruction order.
-    FT_Library library;
-    if (FT_Init_FreeType(&library) != 0)
+    // Get the FreeType library shared by all the fonts
+    // Note: it is reference-counted rather than global, so that it is created and
+    // destroyed with the fonts, and not at an undefined time of the program
+    FT_Library library = acquireLibrary();
+    if (!library)
     {
         err() << "Failed to load font from stream (failed to initialize FreeType)" << std::endl;
         return false;
@@ -212,7 +691,12 @@ bool Font::loadFromStream(InputStream& stream)
 
     // Load the new font face from the specified stream
     FT_Face face;
-    if (FT_Open_Face(static_cast<FT_Library>(m_library), &args, 0, &face) != 0)
+    FT_Error error;
+    {
+        sf::Lock lock(libraryMutex);
+        error = FT_Open_Face(static_cast<FT_Library>(m_library), &args, 0, &face);
+    }
+    if (error != 0)
     {
         err() << "Failed to load font from stream (failed to create the font face)" << std::endl;
         return false;
@@ -236,25 +720,47 @@ bool Font::loadFromStream(InputStream& stream)
 ////////////////////////////////////////////////////////////
 const Glyph& Font::getGlyph(Uint32 codePoint, unsigned int characterSize, bool bold) const
 {
-    // Get the page corresponding to the character size
-    GlyphTable& glyphs = m_pages[characterSize].glyphs;
+    // Add the glyphs of the background preloads that are ready
+    if (!m_preloads.empty())
+        commitPreloads(false);
 
     // Build the key by combining the code point and the bold flag
     Uint32 key = ((bold ? 1 : 0) << 31) | codePoint;
 
-    // Search the glyph into the cache
+    // Search the glyph into the fast lookup table first
+    SizeCache& cache = getSizeCache(characterSize);
+    const Glyph* const* cached = cache.glyphs.find(key);
+    if (cached)
+        return **cached;
+
+    // Then into the table of the glyphs corresponding to the character size
+    GlyphTable& glyphs = m_distanceField ? m_scaledGlyphs[characterSize] : getPage(characterSize).glyphs;
     GlyphTable::const_iterator it = glyphs.find(key);
-    if (it != glyphs.end())
-    {
-        // Found: just return it
-        return it->second;
-    }
-    else
+    if (it == glyphs.end())
     {
         // Not found: we have to load it
-        Glyph glyph = loadGlyph(codePoint, characterSize, bold);
-        return glyphs.insert(std::make_pair(key, glyph)).first->second;
+        Glyph glyph;
+        if (m_distanceField)
+        {
+            // Distance field glyphs are loaded once at the reference size, then scaled
+            GlyphTable& reference = getPage(characterSize).glyphs;
+            GlyphTable::const_iterator found = reference.find(key);
+            if (found == reference.end())
+                found = reference.insert(std::make_pair(key, loadGlyph(codePoint, characterSize, bold))).first;
+
+            glyph = scaleGlyph(found->second, characterSize);
+        }
+        else
+        {
+            glyph = loadGlyph(codePoint, characterSize, bold);
+        }
+        it = glyphs.insert(std::make_pair(key, glyph)).first;
     }
+
+    // Remember where the glyph is; elements of the glyph tables never move
+    cache.glyphs.insert(key, &it->second);
+
+    return it->second;
 }
 
 
@@ -267,24 +773,32 @@ int Font::getKerning(Uint32 first, Uint32 second, unsigned int characterSize) co
 
     FT_Face face = static_cast<FT_Face>(m_face);
 
-    if (face && FT_HAS_KERNING(face) && setCurrentSize(characterSize))
+    // Invalid font, or no kerning
+    if (!face || !FT_HAS_KERNING(face))
+        return 0;
+
+    // Search the pair into the cache
+    SizeCache& cache = getSizeCache(characterSize);
+    Uint64 key = (static_cast<Uint64>(first) << 32) | second;
+    const int* cached = cache.kernings.find(key);
+    if (cached)
+        return *cached;
+
+    int kerning = 0;
+    if (setCurrentSize(characterSize))
     {
         // Convert the characters to indices
         FT_UInt index1 = FT_Get_Char_Index(face, first);
         FT_UInt index2 = FT_Get_Char_Index(face, second);
 
-        // Get the kerning vector
-        FT_Vector kerning;
-        FT_Get_Kerning(face, index1, index2, FT_KERNING_DEFAULT, &kerning);
-
-        // Return the X advance
-        return kerning.x >> 6;
-    }
-    else
-    {
-        // Invalid font, or no kerning
-        return 0;
+        // Get the kerning vector, and keep the X advance
+        FT_Vector vector;
+        FT_Get_Kerning(face, index1, index2, FT_KERNING_DEFAULT, &vector);
+        kerning = vector.x >> 6;
     }
+    cache.kernings.insert(key, kerning);
+
+    return kerning;
 }
 
 
@@ -293,9 +807,17 @@ int Font::getLineSpacing(unsigned int characterSize) const
 {
     FT_Face face = static_cast<FT_Face>(m_face);
 
-    if (face && setCurrentSize(characterSize))
+    if (face)
     {
-        return (face->size->metrics.height >> 6);
+        // The line spacing is computed once per character size
+        SizeCache& cache = getSizeCache(characterSize);
+        if (!cache.hasLineSpacing && setCurrentSize(characterSize))
+        {
+            cache.lineSpacing    = face->size->metrics.height >> 6;
+            cache.hasLineSpacing = true;
+        }
+
+        return cache.lineSpacing;
     }
     else
     {
@@ -304,10 +826,161 @@ int Font::getLineSpacing(unsigned int characterSize) const
 }
 
 
+////////////////////////////////////////////////////////////
+TextLayout Font::getLayout(const String& string, unsigned int characterSize, bool bold, float maxWidth) const
+{
+    // Hash the string and the layout parameters
+    Uint64 key = 14695981039346656037ULL;
+    for (String::ConstIterator it = string.begin(); it != string.end(); ++it)
+        key = hashValue(key, *it);
+    key = hashValue(key, characterSize);
+    key = hashValue(key, bold ? 1u : 0u);
+    key = hashValue(key, maxWidth);
+
+    // Return the cached layout, unless another string or parameters have the same hash
+    LayoutTable::iterator it = m_layouts.find(key);
+    if (it != m_layouts.end())
+    {
+        const CachedLayout& cached = *it->second;
+        if ((cached.characterSize == characterSize) && (cached.bold == bold) && (cached.maxWidth == maxWidth) && (cached.string == string))
+            return cached.layout;
+
+        delete it->second;
+        m_layouts.erase(it);
+    }
+
+    // Make room for the new layout
+    if (m_layouts.size() >= maxCachedLayouts)
+        clearLayouts();
+
+    // Compute the layout and cache it
+    CachedLayout* cached = new CachedLayout;
+    cached->string        = string;
+    cached->characterSize = characterSize;
+    cached->bold          = bold;
+    cached->maxWidth      = maxWidth;
+    cached->layout.reset(*this, characterSize, bold, maxWidth);
+    cached->layout.append(string);
+    m_layouts.insert(std::make_pair(key, cached));
+
+    return cached->layout;
+}
+
+
 ////////////////////////////////////////////////////////////
 const Texture& Font::getTexture(unsigned int characterSize) const
 {
-    return m_pages[characterSize].texture;
+    // Add the glyphs of the background preloads that are ready
+    if (!m_preloads.empty())
+        commitPreloads(false);
+
+    Page& page = getPage(characterSize);
+
+    // Upload the glyphs loaded since the last time the texture was requested
+    uploadPage(page);
+
+    return page.texture;
+}
+
+
+////////////////////////////////////////////////////////////
+void Font::preload(const String& characters, unsigned int characterSize, bool bold) const
+{
+    if (!m_face)
+        return;
+
+    // Fonts loaded from a stream can only be read by one thread
+    if (m_fileName.empty() && !m_fileData)
+    {
+        for (std::size_t i = 0; i < characters.getSize(); ++i)
+            getGlyph(characters[i], characterSize, bold);
+        return;
+    }
+
+    // Add the previous preloads first, so that their glyphs are not loaded twice
+    commitPreloads(false);
+
+    Preload* preload = createPreload(characters, characterSize, bold);
+    if (preload)
+    {
+        preload->run();
+        commitPreload(*preload);
+        delete preload;
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void Font::preloadAsync(const String& characters, unsigned int characterSize, bool bold) const
+{
+    if (!m_face)
+        return;
+
+    // Fonts loaded from a stream can only be read by one thread
+    if (m_fileName.empty() && !m_fileData)
+    {
+        for (std::size_t i = 0; i < characters.getSize(); ++i)
+            getGlyph(characters[i], characterSize, bold);
+        return;
+    }
+
+    Preload* preload = createPreload(characters, characterSize, bold);
+    if (preload)
+    {
+        preload->thread = new Thread(&Preload::run, preload);
+        preload->thread->launch();
+        m_preloads.push_back(preload);
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+float Font::getFillRatio(unsigned int characterSize) const
+{
+    PageTable::const_iterator it = m_pages.find(m_distanceField ? distanceFieldPage : characterSize);
+    if (it == m_pages.end())
+        return 0.f;
+
+    Vector2u size = it->second.packer->getSize();
+    return static_cast<float>(it->second.packer->getUsedArea()) / (static_cast<float>(size.x) * size.y);
+}
+
+
+////////////////////////////////////////////////////////////
+void Font::setDistanceField(bool distanceField)
+{
+    if (distanceField == m_distanceField)
+        return;
+
+    // Wait for the background preloads, their glyphs are rasterized for the previous mode
+    commitPreloads(true);
+
+    // The glyphs of the previous mode are useless now
+    clearSizeCaches();
+    clearLayouts();
+    m_pages.clear();
+    m_scaledGlyphs.clear();
+
+    if (distanceField)
+        acquireDistanceFieldShader();
+    else
+        releaseDistanceFieldShader();
+
+    m_distanceField = distanceField;
+}
+
+
+////////////////////////////////////////////////////////////
+bool Font::isDistanceField() const
+{
+    return m_distanceField;
+}
+
+
+////////////////////////////////////////////////////////////
+const Shader* Font::getShader() const
+{
+    return m_distanceField ? getDistanceFieldShader() : NULL;
 }
 
 
@@ -316,11 +989,20 @@ Font& Font::operator =(const Font& right)
 {
     Font temp(right);
 
-    std::swap(m_library,     temp.m_library);
-    std::swap(m_face,        temp.m_face);
-    std::swap(m_pages,       temp.m_pages);
-    std::swap(m_pixelBuffer, temp.m_pixelBuffer);
-    std::swap(m_refCount,    temp.m_refCount);
+    std::swap(m_library,       temp.m_library);
+    std::swap(m_face,          temp.m_face);
+    std::swap(m_pages,         temp.m_pages);
+    std::swap(m_refCount,      temp.m_refCount);
+    std::swap(m_fileName,      temp.m_fileName);
+    std::swap(m_fileData,      temp.m_fileData);
+    std::swap(m_fileSize,      temp.m_fileSize);
+    std::swap(m_preloads,      temp.m_preloads);
+    std::swap(m_distanceField, temp.m_distanceField);
+    std::swap(m_scaledGlyphs,  temp.m_scaledGlyphs);
+    std::swap(m_sizeCaches,    temp.m_sizeCaches);
+    std::swap(m_lastSize,      temp.m_lastSize);
+    std::swap(m_lastCache,     temp.m_lastCache);
+    std::swap(m_layouts,       temp.m_layouts);
 
     return *this;
 }
@@ -329,6 +1011,11 @@ Font& Font::operator =(const Font& right)
 ////////////////////////////////////////////////////////////
 void Font::cleanup()
 {
+    // Wait for the background preloads, they may still be reading the font
+    for (std::vector<Preload*>::iterator it = m_preloads.begin(); it != m_preloads.end(); ++it)
+        delete *it;
+    m_preloads.clear();
+
     // Check if we must destroy the FreeType pointers
     if (m_refCount)
     {
@@ -343,15 +1030,18 @@ void Font::cleanup()
 
             // Destroy the font face
             if (m_face)
+            {
+                sf::Lock lock(libraryMutex);
                 FT_Done_Face(static_cast<FT_Face>(m_face));
+            }
 
             // Destroy the stream rec instance, if any (must be done after FT_Done_Face!)
             if (m_streamRec)
                 delete static_cast<FT_StreamRec*>(m_streamRec);
 
-            // Close the library
+            // Release the library
             if (m_library)
-                FT_Done_FreeType(static_cast<FT_Library>(m_library));
+                releaseLibrary();
         }
     }
 
@@ -360,8 +1050,13 @@ void Font::cleanup()
     m_face      = NULL;
     m_streamRec = NULL;
     m_refCount  = NULL;
+    m_fileData  = NULL;
+    m_fileSize  = 0;
+    m_fileName.clear();
+    clearSizeCaches();
+    clearLayouts();
     m_pages.clear();
-    m_pixelBuffer.clear();
+    m_scaledGlyphs.clear();
 }
 
 
@@ -376,18 +1071,35 @@ Glyph Font::loadGlyph(Uint32 codePoint, unsigned int characterSize, bool bold) c
     if (!face)
         return glyph;
 
-    // Set the character size
-    if (!setCurrentSize(characterSize))
+    // Set the character size; distance field glyphs are rasterized at the reference size
+    if (!setCurrentSize(m_distanceField ? distanceFieldSize : characterSize))
         return glyph;
 
-    // Load the glyph corresponding to the code point
-    if (FT_Load_Char(face, codePoint, FT_LOAD_TARGET_NORMAL) != 0)
+    // Rasterize the glyph
+    GlyphBitmap bitmap;
+    if (!rasterizeGlyph(m_library, m_face, codePoint, bold, bitmap))
         return glyph;
 
+    if (m_distanceField)
+        makeDistanceField(bitmap);
+
+    // Add it to the page corresponding to the character size
+    return addGlyph(getPage(characterSize), bitmap);
+}
+
+
+////////////////////////////////////////////////////////////
+bool Font::rasterizeGlyph(void* library, void* face, Uint32 codePoint, bool bold, GlyphBitmap& bitmap)
+{
+    // Load the glyph corresponding to the code point
+    FT_Face ftFace = static_cast<FT_Face>(face);
+    if (FT_Load_Char(ftFace, codePoint, FT_LOAD_TARGET_NORMAL) != 0)
+        return false;
+
     // Retrieve the glyph
     FT_Glyph glyphDesc;
-    if (FT_Get_Glyph(face->glyph, &glyphDesc) != 0)
-        return glyph;
+    if (FT_Get_Glyph(ftFace->glyph, &glyphDesc) != 0)
+        return false;
 
     // Apply bold if necessary -- first technique using outline (highest quality)
     FT_Pos weight = 1 << 6;
@@ -401,152 +1113,350 @@ Glyph Font::loadGlyph(Uint32 codePoint, unsigned int characterSize, bool bold) c
     // Convert the glyph to a bitmap (i.e. rasterize it)
     FT_Glyph_To_Bitmap(&glyphDesc, FT_RENDER_MODE_NORMAL, 0, 1);
     FT_BitmapGlyph bitmapGlyph = (FT_BitmapGlyph)glyphDesc;
-    FT_Bitmap& bitmap = bitmapGlyph->bitmap;
+    FT_Bitmap& ftBitmap = bitmapGlyph->bitmap;
 
     // Apply bold if necessary -- fallback technique using bitmap (lower quality)
     if (bold && !outline)
     {
-        FT_Bitmap_Embolden(static_cast<FT_Library>(m_library), &bitmap, weight, weight);
+        FT_Bitmap_Embolden(static_cast<FT_Library>(library), &ftBitmap, weight, weight);
     }
 
     // Compute the glyph's advance offset
-    glyph.advance = glyphDesc->advance.x >> 16;
+    bitmap.advance = glyphDesc->advance.x >> 16;
     if (bold)
-        glyph.advance += weight >> 6;
+        bitmap.advance += weight >> 6;
+
+    bitmap.left   = bitmapGlyph->left;
+    bitmap.top    = bitmapGlyph->top;
+    bitmap.width  = ftBitmap.width;
+    bitmap.height = ftBitmap.rows;
+
+    // Extract the glyph's pixels from the bitmap
+    bitmap.pixels.resize(bitmap.width * bitmap.height);
+    const Uint8* pixels = ftBitmap.buffer;
+    Uint8* dst = bitmap.pixels.empty() ? NULL : &bitmap.pixels[0];
+    if (ftBitmap.pixel_mode == FT_PIXEL_MODE_MONO)
+    {
+        // Pixels are 1 bit monochrome values
+        for (unsigned int y = 0; y < bitmap.height; ++y)
+        {
+            for (unsigned int x = 0; x < bitmap.width; ++x)
+                dst[x] = ((pixels[x / 8]) & (1 << (7 - (x % 8)))) ? 255 : 0;
+            pixels += ftBitmap.pitch;
+            dst += bitmap.width;
+        }
+    }
+    else
+    {
+        // Pixels are 8 bits gray levels
+        for (unsigned int y = 0; y < bitmap.height; ++y)
+        {
+            std::memcpy(dst, pixels, bitmap.width);
+            pixels += ftBitmap.pitch;
+            dst += bitmap.width;
+        }
+    }
+
+    // Delete the FT glyph
+    FT_Done_Glyph(glyphDesc);
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+void Font::makeDistanceField(GlyphBitmap& bitmap)
+{
+    if ((bitmap.width == 0) || (bitmap.height == 0))
+        return;
+
+    // The distances spread on each side of the glyph
+    int spread = static_cast<int>(distanceFieldSpread);
+    int width  = static_cast<int>(bitmap.width) + 2 * spread;
+    int height = static_cast<int>(bitmap.height) + 2 * spread;
+
+    // Pixels more than half covered are inside the glyph; compute the distance
+    // from every outside pixel to the inside, and from every inside pixel to the outside
+    std::vector<float> outside(width * height, 1e20f);
+    std::vector<float> inside(width * height, 0.f);
+    for (unsigned int y = 0; y < bitmap.height; ++y)
+    {
+        for (unsigned int x = 0; x < bitmap.width; ++x)
+        {
+            if (bitmap.pixels[y * bitmap.width + x] >= 128)
+            {
+                std::size_t index = (y + spread) * width + x + spread;
+                outside[index] = 0.f;
+                inside[index]  = 1e20f;
+            }
+        }
+    }
+    distanceTransform(outside, width, height);
+    distanceTransform(inside, width, height);
+
+    // Map the signed distances (the edge is halfway between pixel centers) to [0, 255]:
+    // 0.5 is the edge, 1 is spread pixels inside, 0 is spread pixels outside
+    bitmap.pixels.resize(width * height);
+    for (std::size_t i = 0; i < bitmap.pixels.size(); ++i)
+    {
+        float distance = (outside[i] > 0.f) ? std::sqrt(outside[i]) - 0.5f : 0.5f - std::sqrt(inside[i]);
+        float value = 0.5f - distance / (2.f * spread);
+        bitmap.pixels[i] = static_cast<Uint8>(std::min(std::max(value, 0.f), 1.f) * 255.f + 0.5f);
+    }
+
+    bitmap.left  -= spread;
+    bitmap.top   += spread;
+    bitmap.width  = width;
+    bitmap.height = height;
+}
+
+
+////////////////////////////////////////////////////////////
+Font::Page& Font::getPage(unsigned int characterSize) const
+{
+    return m_pages[m_distanceField ? distanceFieldPage : characterSize];
+}
+
+
+////////////////////////////////////////////////////////////
+Font::SizeCache& Font::getSizeCache(unsigned int characterSize) const
+{
+    // Texts usually request many glyphs of the same size in a row
+    if (m_lastCache && (m_lastSize == characterSize))
+        return *m_lastCache;
+
+    SizeCache*& cache = m_sizeCaches[characterSize];
+    if (!cache)
+        cache = new SizeCache;
 
-    int width  = bitmap.width;
-    int height = bitmap.rows;
+    m_lastSize  = characterSize;
+    m_lastCache = cache;
+
+    return *cache;
+}
+
+
+////////////////////////////////////////////////////////////
+void Font::clearSizeCaches() const
+{
+    for (SizeCacheTable::iterator it = m_sizeCaches.begin(); it != m_sizeCaches.end(); ++it)
+        delete it->second;
+
+    m_sizeCaches.clear();
+    m_lastCache = NULL;
+}
+
+
+////////////////////////////////////////////////////////////
+void Font::clearLayouts() const
+{
+    for (LayoutTable::iterator it = m_layouts.begin(); it != m_layouts.end(); ++it)
+        delete it->second;
+
+    m_layouts.clear();
+}
+
+
+////////////////////////////////////////////////////////////
+Glyph Font::addGlyph(Page& page, const GlyphBitmap& bitmap) const
+{
+    Glyph glyph;
+    glyph.advance = bitmap.advance;
+
+    unsigned int width  = bitmap.width;
+    unsigned int height = bitmap.height;
     if ((width > 0) && (height > 0))
     {
         // Leave a small padding around characters, so that filtering doesn't
         // pollute them with pixels from neighbours
         const unsigned int padding = 1;
 
-        // Get the glyphs page corresponding to the character size
-        Page& page = m_pages[characterSize];
-
         // Find a good position for the new glyph into the texture
         glyph.textureRect = findGlyphRect(page, width + 2 * padding, height + 2 * padding);
 
         // Compute the glyph's bounding box
-        glyph.bounds.left   = bitmapGlyph->left - padding;
-        glyph.bounds.top    = -bitmapGlyph->top - padding;
+        glyph.bounds.left   = bitmap.left - static_cast<int>(padding);
+        glyph.bounds.top    = -bitmap.top - static_cast<int>(padding);
         glyph.bounds.width  = width + 2 * padding;
         glyph.bounds.height = height + 2 * padding;
 
-        // Extract the glyph's pixels from the bitmap
-        m_pixelBuffer.resize(width * height * 4, 255);
-        const Uint8* pixels = bitmap.buffer;
-        if (bitmap.pixel_mode == FT_PIXEL_MODE_MONO)
+        // Write the glyph's pixels to the copy of the texture; they will be
+        // uploaded with the other new glyphs the next time the texture is requested
+        unsigned int left = glyph.textureRect.left + padding;
+        unsigned int top  = glyph.textureRect.top + padding;
+        std::size_t pitch = page.packer->getSize().x;
+        Uint8* dst = &page.pixels[top * pitch + left];
+        const Uint8* src = &bitmap.pixels[0];
+        for (unsigned int y = 0; y < height; ++y)
         {
-            // Pixels are 1 bit monochrome values
-            for (int y = 0; y < height; ++y)
-            {
-                for (int x = 0; x < width; ++x)
-                {
-                    // The color channels remain white, just fill the alpha channel
-                    std::size_t index = (x + y * width) * 4 + 3;
-                    m_pixelBuffer[index] = ((pixels[x / 8]) & (1 << (7 - (x % 8)))) ? 255 : 0;
-                }
-                pixels += bitmap.pitch;
-            }
+            std::memcpy(dst, src, width);
+            src += width;
+            dst += pitch;
+        }
+
+        // Extend the range of rows that must be uploaded
+        if (page.dirtyTop >= page.dirtyBottom)
+        {
+            page.dirtyTop    = top;
+            page.dirtyBottom = top + height;
         }
         else
         {
-            // Pixels are 8 bits gray levels
-            for (int y = 0; y < height; ++y)
-            {
-                for (int x = 0; x < width; ++x)
-                {
-                    // The color channels remain white, just fill the alpha channel
-                    std::size_t index = (x + y * width) * 4 + 3;
-                    m_pixelBuffer[index] = pixels[x];
-                }
-                pixels += bitmap.pitch;
-            }
+            page.dirtyTop    = std::min(page.dirtyTop, top);
+            page.dirtyBottom = std::max(page.dirtyBottom, top + height);
         }
-
-        // Write the pixels to the texture
-        unsigned int x = glyph.textureRect.left + padding;
-        unsigned int y = glyph.textureRect.top + padding;
-        unsigned int w = glyph.textureRect.width - 2 * padding;
-        unsigned int h = glyph.textureRect.height - 2 * padding;
-        page.texture.update(&m_pixelBuffer[0], w, h, x, y);
     }
 
-    // Delete the FT glyph
-    FT_Done_Glyph(glyphDesc);
-
-    // Done :)
     return glyph;
 }
 
 
 ////////////////////////////////////////////////////////////
-IntRect Font::findGlyphRect(Page& page, unsigned int width, unsigned int height) const
+void Font::commitPreloads(bool wait) const
+{
+    std::vector<Preload*>::iterator it = m_preloads.begin();
+    while (it != m_preloads.end())
+    {
+        Preload* preload = *it;
+
+        bool finished = wait;
+        if (!finished)
+        {
+            Lock lock(preload->mutex);
+            finished = preload->finished;
+        }
+
+        if (finished)
+        {
+            // Wait for the thread to end, then add the glyphs to the font
+            delete preload->thread;
+            preload->thread = NULL;
+            commitPreload(*preload);
+            delete preload;
+            it = m_preloads.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+Font::Preload* Font::createPreload(const String& characters, unsigned int characterSize, bool bold) const
 {
-    // Find the line that fits well the glyph
-    Row* row = NULL;
-    float bestRatio = 0;
-    for (std::vector<Row>::iterator it = page.rows.begin(); it != page.rows.end() && !row; ++it)
+    const GlyphTable& glyphs = getPage(characterSize).glyphs;
+    Uint32 flag = (bold ? 1 : 0) << 31;
+
+    // Keep only the characters that are not loaded yet, once each
+    std::vector<Uint32> codePoints;
+    for (std::size_t i = 0; i < characters.getSize(); ++i)
     {
-        float ratio = static_cast<float>(height) / it->height;
+        Uint32 codePoint = characters[i];
+        if (glyphs.find(flag | codePoint) == glyphs.end())
+            codePoints.push_back(codePoint);
+    }
+    std::sort(codePoints.begin(), codePoints.end());
+    codePoints.erase(std::unique(codePoints.begin(), codePoints.end()), codePoints.end());
+
+    if (codePoints.empty())
+        return NULL;
+
+    Preload* preload = new Preload;
+    preload->fileName      = m_fileName;
+    preload->fileData      = m_fileData;
+    preload->fileSize      = m_fileSize;
+    preload->characterSize = m_distanceField ? distanceFieldSize : characterSize;
+    preload->bold          = bold;
+    preload->distanceField = m_distanceField;
+    preload->codePoints.swap(codePoints);
+    preload->bitmaps.resize(preload->codePoints.size());
+    preload->loaded.resize(preload->codePoints.size(), 0);
+
+    return preload;
+}
 
-        // Ignore rows that are either too small or too high
-        if ((ratio < 0.7f) || (ratio > 1.f))
-            continue;
 
-        // Check if there's enough horizontal space left in the row
-        if (width > page.texture.getSize().x - it->width)
-            continue;
+////////////////////////////////////////////////////////////
+void Font::commitPreload(Preload& preload) const
+{
+    Page& page = getPage(preload.characterSize);
+    Uint32 flag = (preload.bold ? 1 : 0) << 31;
 
-        // Make sure that this new row is the best found so far
-        if (ratio < bestRatio)
-            continue;
+    // Pack the tallest glyphs first, the skyline wastes less space this way
+    std::vector<std::size_t> order;
+    for (std::size_t i = 0; i < preload.codePoints.size(); ++i)
+    {
+        if (preload.loaded[i])
+            order.push_back(i);
+    }
+    std::sort(order.begin(), order.end(), BitmapHeightGreater<GlyphBitmap>(preload.bitmaps));
 
-        // The current row passed all the tests: we can select it
-        row = &*it;
-        bestRatio = ratio;
+    for (std::vector<std::size_t>::const_iterator it = order.begin(); it != order.end(); ++it)
+    {
+        // The glyph may have been loaded by getGlyph in the meantime
+        Uint32 key = flag | preload.codePoints[*it];
+        if (page.glyphs.find(key) == page.glyphs.end())
+            page.glyphs.insert(std::make_pair(key, addGlyph(page, preload.bitmaps[*it])));
     }
+}
 
-    // If we didn't find a matching row, create a new one (10% taller than the glyph)
-    if (!row)
+
+////////////////////////////////////////////////////////////
+IntRect Font::findGlyphRect(Page& page, unsigned int width, unsigned int height) const
+{
+    Vector2u position;
+    while (!page.packer->insert(width, height, position))
     {
-        int rowHeight = height + height / 10;
-        while (page.nextRow + rowHeight >= page.texture.getSize().y)
+        // Not enough space: resize the texture if possible
+        unsigned int textureWidth  = page.texture.getSize().x;
+        unsigned int textureHeight = page.texture.getSize().y;
+        if ((textureWidth * 2 <= Texture::getMaximumSize()) && (textureHeight * 2 <= Texture::getMaximumSize()))
         {
-            // Not enough space: resize the texture if possible
-            unsigned int textureWidth  = page.texture.getSize().x;
-            unsigned int textureHeight = page.texture.getSize().y;
-            if ((textureWidth * 2 <= Texture::getMaximumSize()) && (textureHeight * 2 <= Texture::getMaximumSize()))
-            {
-                // Make the texture 2 times bigger
-                Image newImage;
-                newImage.create(textureWidth * 2, textureHeight * 2, Color(255, 255, 255, 0));
-                newImage.copy(page.texture.copyToImage(), 0, 0);
-                page.texture.loadFromImage(newImage);
-            }
-            else
-            {
-                // Oops, we've reached the maximum texture size...
-                err() << "Failed to add a new character to the font: the maximum texture size has been reached" << std::endl;
+            // Make the copy of the pixels 2 times bigger, the new areas are cleared
+            std::vector<Uint8> pixels(textureWidth * textureHeight * 4, 0);
+            for (unsigned int y = 0; y < textureHeight; ++y)
+                std::memcpy(&pixels[y * textureWidth * 2], &page.pixels[y * textureWidth], textureWidth);
+
+            // Alpha textures can't be attached to frame buffers and copied on the graphics
+            // card; since the copy contains all the glyphs, it's uploaded in a single pass
+            Texture texture;
+            if (!texture.create(textureWidth * 2, textureHeight * 2, Texture::Alpha))
                 return IntRect(0, 0, 2, 2);
-            }
+            texture.update(&pixels[0]);
+            texture.setSmooth(true);
+
+            page.texture.swap(texture);
+            page.packer->resize(textureWidth * 2, textureHeight * 2);
+            page.pixels.swap(pixels);
+            page.dirtyTop    = 0;
+            page.dirtyBottom = 0;
+        }
+        else
+        {
+            // Oops, we've reached the maximum texture size...
+            err() << "Failed to add a new character to the font: the maximum texture size has been reached" << std::endl;
+            return IntRect(0, 0, 2, 2);
         }
-
-        // We can now create the new row
-        page.rows.push_back(Row(page.nextRow, rowHeight));
-        page.nextRow += rowHeight;
-        row = &page.rows.back();
     }
 
-    // Find the glyph's rectangle on the selected row
-    IntRect rect(row->width, row->top, width, height);
+    return IntRect(position.x, position.y, width, height);
+}
 
-    // Update the row informations
-    row->width += width;
 
-    return rect;
+////////////////////////////////////////////////////////////
+void Font::uploadPage(Page& page) const
+{
+    if (page.dirtyTop < page.dirtyBottom)
+    {
+        // Upload whole rows, so that the pixels to upload are contiguous
+        unsigned int width = page.packer->getSize().x;
+        page.texture.update(&page.pixels[page.dirtyTop * width], width, page.dirtyBottom - page.dirtyTop, 0, page.dirtyTop);
+
+        page.dirtyTop    = 0;
+        page.dirtyBottom = 0;
+    }
 }
 
 
@@ -572,20 +1482,61 @@ bool Font::setCurrentSize(unsigned int characterSize) const
 
 ////////////////////////////////////////////////////////////
 Font::Page::Page() :
-nextRow(2)
+packer     (new priv::SkylinePacker(128, 128)),
+dirtyTop   (0),
+dirtyBottom(0)
 {
     // Make sure that the texture is initialized by default
-    sf::Image image;
-    image.create(128, 128, Color(255, 255, 255, 0));
+    pixels.assign(128 * 128, 0);
 
     // Reserve a 2x2 white square for texturing underlines
     for (int x = 0; x < 2; ++x)
         for (int y = 0; y < 2; ++y)
-            image.setPixel(x, y, Color(255, 255, 255, 255));
+            pixels[x + y * 128] = 255;
 
-    // Create the texture
-    texture.loadFromImage(image);
+    // Create the texture; glyphs only need an alpha channel, the color is always white
+    texture.create(128, 128, Texture::Alpha);
+    texture.update(&pixels[0]);
     texture.setSmooth(true);
+
+    // The white square is always packed at the top-left corner
+    Vector2u position;
+    packer->insert(2, 2, position);
+}
+
+
+////////////////////////////////////////////////////////////
+Font::Page::Page(const Page& copy) :
+glyphs     (copy.glyphs),
+texture    (copy.texture),
+packer     (new priv::SkylinePacker(*copy.packer)),
+pixels     (copy.pixels),
+dirtyTop   (copy.dirtyTop),
+dirtyBottom(copy.dirtyBottom)
+{
+}
+
+
+////////////////////////////////////////////////////////////
+Font::Page::~Page()
+{
+    delete packer;
+}
+
+
+////////////////////////////////////////////////////////////
+Font::Page& Font::Page::operator =(const Page& right)
+{
+    Page temp(right);
+
+    std::swap(glyphs,      temp.glyphs);
+    std::swap(packer,      temp.packer);
+    std::swap(pixels,      temp.pixels);
+    std::swap(dirtyTop,    temp.dirtyTop);
+    std::swap(dirtyBottom, temp.dirtyBottom);
+    texture.swap(temp.texture);
+
+    return *this;
 }
 
 } // namespace sf
@@ -0,0 +1,169 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2012 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Graphics/FontRegistry.hpp>
+#include <SFML/Graphics/Font.hpp>
+#include <cstring>
+
+
+namespace
+{
+    // Hash the contents of a font file (64-bits FNV-1a)
+    sf::Uint64 hashContents(const void* data, std::size_t size)
+    {
+        const sf::Uint8* bytes = static_cast<const sf::Uint8*>(data);
+        sf::Uint64 hash = 14695981039346656037ULL;
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            hash ^= bytes[i];
+            hash *= 1099511628211ULL;
+        }
+
+        return hash;
+    }
+}
+
+
+namespace sf
+{
+////////////////////////////////////////////////////////////
+FontRegistry::FontRegistry() :
+m_files (),
+m_memory()
+{
+}
+
+
+////////////////////////////////////////////////////////////
+FontRegistry::~FontRegistry()
+{
+    clear();
+}
+
+
+////////////////////////////////////////////////////////////
+Font* FontRegistry::loadFromFile(const std::string& filename)
+{
+    // Already loaded?
+    FileTable::iterator it = m_files.find(filename);
+    if (it != m_files.end())
+        return it->second;
+
+    Font* font = new Font;
+    if (!font->loadFromFile(filename))
+    {
+        delete font;
+        return NULL;
+    }
+
+    m_files.insert(std::make_pair(filename, font));
+
+    return font;
+}
+
+
+////////////////////////////////////////////////////////////
+Font* FontRegistry::loadFromMemory(const void* data, std::size_t sizeInBytes)
+{
+    if (!data || (sizeInBytes == 0))
+        return NULL;
+
+    // Already loaded from the same contents? Fonts with the same hash must
+    // also be compared byte by byte, different contents may collide
+    Uint64 hash = hashContents(data, sizeInBytes);
+    std::pair<MemoryTable::iterator, MemoryTable::iterator> range = m_memory.equal_range(hash);
+    for (MemoryTable::iterator it = range.first; it != range.second; ++it)
+    {
+        const MemoryFont& entry = it->second;
+        if ((entry.size == sizeInBytes) && ((entry.data == data) || (std::memcmp(entry.data, data, sizeInBytes) == 0)))
+            return entry.font;
+    }
+
+    Font* font = new Font;
+    if (!font->loadFromMemory(data, sizeInBytes))
+    {
+        delete font;
+        return NULL;
+    }
+
+    MemoryFont entry;
+    entry.data = data;
+    entry.size = sizeInBytes;
+    entry.font = font;
+    m_memory.insert(std::make_pair(hash, entry));
+
+    return font;
+}
+
+
+////////////////////////////////////////////////////////////
+void FontRegistry::remove(const Font* font)
+{
+    for (FileTable::iterator it = m_files.begin(); it != m_files.end(); ++it)
+    {
+        if (it->second == font)
+        {
+            delete it->second;
+            m_files.erase(it);
+            return;
+        }
+    }
+
+    for (MemoryTable::iterator it = m_memory.begin(); it != m_memory.end(); ++it)
+    {
+        if (it->second.font == font)
+        {
+            delete it->second.font;
+            m_memory.erase(it);
+            return;
+        }
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void FontRegistry::clear()
+{
+    for (FileTable::iterator it = m_files.begin(); it != m_files.end(); ++it)
+        delete it->second;
+
+    for (MemoryTable::iterator it = m_memory.begin(); it != m_memory.end(); ++it)
+        delete it->second.font;
+
+    m_files.clear();
+    m_memory.clear();
+}
+
+
+////////////////////////////////////////////////////////////
+std::size_t FontRegistry::getFontCount() const
+{
+    return m_files.size() + m_memory.size();
+}
+
+} // namespace sf
@@ -0,0 +1,142 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2012 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Graphics/IndexArray.hpp>
+#include <cstddef>
+
+
+namespace sf
+{
+////////////////////////////////////////////////////////////
+IndexArray::IndexArray() :
+m_type     (Index16),
+m_indices16(),
+m_indices32()
+{
+}
+
+
+////////////////////////////////////////////////////////////
+IndexArray::IndexArray(Type type, unsigned int indexCount) :
+m_type     (type),
+m_indices16(),
+m_indices32()
+{
+    resize(indexCount);
+}
+
+
+////////////////////////////////////////////////////////////
+unsigned int IndexArray::getIndexCount() const
+{
+    if (m_type == Index16)
+        return static_cast<unsigned int>(m_indices16.size());
+    else
+        return static_cast<unsigned int>(m_indices32.size());
+}
+
+
+////////////////////////////////////////////////////////////
+IndexArray::Type IndexArray::getType() const
+{
+    return m_type;
+}
+
+
+////////////////////////////////////////////////////////////
+Uint32 IndexArray::operator [](unsigned int position) const
+{
+    if (m_type == Index16)
+        return m_indices16[position];
+    else
+        return m_indices32[position];
+}
+
+
+////////////////////////////////////////////////////////////
+void IndexArray::setIndex(unsigned int position, Uint32 value)
+{
+    if ((m_type == Index16) && (value > 0xFFFF))
+        promote();
+
+    if (m_type == Index16)
+        m_indices16[position] = static_cast<Uint16>(value);
+    else
+        m_indices32[position] = value;
+}
+
+
+////////////////////////////////////////////////////////////
+void IndexArray::clear()
+{
+    m_indices16.clear();
+    m_indices32.clear();
+}
+
+
+////////////////////////////////////////////////////////////
+void IndexArray::resize(unsigned int indexCount)
+{
+    if (m_type == Index16)
+        m_indices16.resize(indexCount);
+    else
+        m_indices32.resize(indexCount);
+}
+
+
+////////////////////////////////////////////////////////////
+void IndexArray::append(Uint32 value)
+{
+    if ((m_type == Index16) && (value > 0xFFFF))
+        promote();
+
+    if (m_type == Index16)
+        m_indices16.push_back(static_cast<Uint16>(value));
+    else
+        m_indices32.push_back(value);
+}
+
+
+////////////////////////////////////////////////////////////
+const void* IndexArray::getData() const
+{
+    if (m_type == Index16)
+        return !m_indices16.empty() ? &m_indices16[0] : NULL;
+    else
+        return !m_indices32.empty() ? &m_indices32[0] : NULL;
+}
+
+
+////////////////////////////////////////////////////////////
+void IndexArray::promote()
+{
+    m_indices32.assign(m_indices16.begin(), m_indices16.end());
+    std::vector<Uint16>().swap(m_indices16);
+    m_type = Index32;
+}
+
+} // namespace sf
@@ -0,0 +1,185 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2012 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Graphics/PixelBuffer.hpp>
+#include <SFML/System/Err.hpp>
+
+
+namespace sf
+{
+namespace priv
+{
+////////////////////////////////////////////////////////////
+PixelBuffer::PixelBuffer(Direction direction) :
+m_direction(direction),
+m_target   (direction == Upload ? GL_PIXEL_UNPACK_BUFFER_ARB : GL_PIXEL_PACK_BUFFER_ARB),
+m_buffer   (0),
+m_size     (0),
+m_fence    (0)
+{
+}
+
+
+////////////////////////////////////////////////////////////
+PixelBuffer::~PixelBuffer()
+{
+    if (m_buffer || m_fence)
+    {
+        ensureGlContext();
+
+        if (m_fence)
+            glCheck(glDeleteSync(m_fence));
+        if (m_buffer)
+            glCheck(glDeleteBuffersARB(1, &m_buffer));
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+bool PixelBuffer::allocate(std::size_t size)
+{
+    ensureGlContext();
+
+    // Create the OpenGL buffer if it doesn't exist yet
+    if (!m_buffer)
+    {
+        glCheck(glGenBuffersARB(1, &m_buffer));
+        if (!m_buffer)
+        {
+            err() << "Failed to create pixel buffer" << std::endl;
+            return false;
+        }
+    }
+
+    GLenum usage = (m_direction == Upload) ? GL_STREAM_DRAW_ARB : GL_STREAM_READ_ARB;
+
+    glCheck(glBindBufferARB(m_target, m_buffer));
+    glCheck(glBufferDataARB(m_target, size, NULL, usage));
+    glCheck(glBindBufferARB(m_target, 0));
+
+    m_size = size;
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+std::size_t PixelBuffer::getSize() const
+{
+    return m_size;
+}
+
+
+////////////////////////////////////////////////////////////
+void* PixelBuffer::map()
+{
+    if (!m_buffer)
+        return NULL;
+
+    GLenum access = (m_direction == Upload) ? GL_WRITE_ONLY_ARB : GL_READ_ONLY_ARB;
+
+    glCheck(glBindBufferARB(m_target, m_buffer));
+    void* data = glMapBufferARB(m_target, access);
+    glCheck(glBindBufferARB(m_target, 0));
+
+    if (!data)
+        err() << "Failed to map pixel buffer" << std::endl;
+
+    return data;
+}
+
+
+////////////////////////////////////////////////////////////
+void PixelBuffer::unmap()
+{
+    if (m_buffer)
+    {
+        glCheck(glBindBufferARB(m_target, m_buffer));
+        glCheck(glUnmapBufferARB(m_target));
+        glCheck(glBindBufferARB(m_target, 0));
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void PixelBuffer::bind() const
+{
+    glCheck(glBindBufferARB(m_target, m_buffer));
+}
+
+
+////////////////////////////////////////////////////////////
+void PixelBuffer::unbind() const
+{
+    glCheck(glBindBufferARB(m_target, 0));
+}
+
+
+////////////////////////////////////////////////////////////
+void PixelBuffer::fence()
+{
+    if (GLEW_ARB_sync)
+    {
+        if (m_fence)
+            glCheck(glDeleteSync(m_fence));
+
+        m_fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+        // Make sure that the fence reaches the GPU, otherwise it may never be signaled
+        glCheck(glFlush());
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+bool PixelBuffer::isReady() const
+{
+    if (!m_fence)
+        return true;
+
+    ensureGlContext();
+
+    GLenum status = glClientWaitSync(m_fence, 0, 0);
+    return (status == GL_ALREADY_SIGNALED) || (status == GL_CONDITION_SATISFIED);
+}
+
+
+////////////////////////////////////////////////////////////
+bool PixelBuffer::isAvailable()
+{
+    ensureGlContext();
+
+    // Make sure that GLEW is initialized
+    priv::ensureGlewInit();
+
+    return GLEW_ARB_pixel_buffer_object && GLEW_ARB_vertex_buffer_object;
+}
+
+} // namespace priv
+
+} // namespace sf
@@ -0,0 +1,183 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2012 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+#ifndef SFML_PIXELBUFFER_HPP
+#define SFML_PIXELBUFFER_HPP
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Graphics/GLCheck.hpp>
+#include <SFML/Window/GlResource.hpp>
+#include <SFML/System/NonCopyable.hpp>
+#include <cstddef>
+
+
+namespace sf
+{
+namespace priv
+{
+////////////////////////////////////////////////////////////
+/// \brief OpenGL pixel buffer object, used for asynchronous
+///        transfers of pixels between the CPU and the GPU
+///
+/// A fence can be inserted after the commands that use
+/// the buffer, to know when the transfer is finished
+/// without blocking.
+///
+////////////////////////////////////////////////////////////
+class PixelBuffer : GlResource, NonCopyable
+{
+public :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Direction of the transfers done through the buffer
+    ///
+    ////////////////////////////////////////////////////////////
+    enum Direction
+    {
+        Upload,  ///< Pixels are written by the CPU and read by the GPU (unpack buffer)
+        Download ///< Pixels are written by the GPU and read by the CPU (pack buffer)
+    };
+
+public :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Default constructor
+    ///
+    /// \param direction Direction of the transfers
+    ///
+    ////////////////////////////////////////////////////////////
+    explicit PixelBuffer(Direction direction);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Destructor
+    ///
+    ////////////////////////////////////////////////////////////
+    ~PixelBuffer();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief (Re-)allocate the storage of the buffer
+    ///
+    /// The previous storage is orphaned: transfers that still
+    /// use it complete normally, and the buffer gets fresh
+    /// memory without waiting for them. The pending fence
+    /// is kept.
+    ///
+    /// \param size Size of the storage, in bytes
+    ///
+    /// \return True on success
+    ///
+    ////////////////////////////////////////////////////////////
+    bool allocate(std::size_t size);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the size of the storage
+    ///
+    /// \return Size of the storage, in bytes
+    ///
+    ////////////////////////////////////////////////////////////
+    std::size_t getSize() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Map the storage into the client memory
+    ///
+    /// Upload buffers are mapped for writing, download buffers
+    /// for reading. Mapping a download buffer waits until the
+    /// GPU has finished writing to it.
+    ///
+    /// \return Pointer to the storage, or NULL on failure
+    ///
+    ////////////////////////////////////////////////////////////
+    void* map();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Unmap the storage
+    ///
+    ////////////////////////////////////////////////////////////
+    void unmap();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Bind the buffer to its pixel transfer target
+    ///
+    /// While the buffer is bound, the pixel pointers given to
+    /// glTexSubImage2D (upload) or glReadPixels / glGetTexImage
+    /// (download) are offsets in the buffer.
+    ///
+    ////////////////////////////////////////////////////////////
+    void bind() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Unbind the buffer from its pixel transfer target
+    ///
+    ////////////////////////////////////////////////////////////
+    void unbind() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Insert a fence after the commands issued so far
+    ///
+    /// Any previous fence is replaced.
+    ///
+    ////////////////////////////////////////////////////////////
+    void fence();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Tell whether the commands before the fence are finished
+    ///
+    /// This function never blocks. If the system doesn't support
+    /// fences, it always returns true: the transfer is then
+    /// finished implicitly when the buffer is mapped.
+    ///
+    /// \return True if the fence was reached or if there's no fence
+    ///
+    ////////////////////////////////////////////////////////////
+    bool isReady() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Tell whether the system supports pixel buffers
+    ///
+    /// \return True if pixel buffer objects are supported
+    ///
+    ////////////////////////////////////////////////////////////
+    static bool isAvailable();
+
+private :
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    Direction   m_direction; ///< Direction of the transfers
+    GLenum      m_target;    ///< OpenGL binding target of the buffer
+    GLuint      m_buffer;    ///< OpenGL identifier of the buffer
+    std::size_t m_size;      ///< Size of the storage, in bytes
+    GLsync      m_fence;     ///< Fence inserted after the last transfer, if any
+};
+
+} // namespace priv
+
+} // namespace sf
+
+
+#endif // SFML_PIXELBUFFER_HPP
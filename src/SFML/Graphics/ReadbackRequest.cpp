@@ -0,0 +1,292 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2012 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Graphics/ReadbackRequest.hpp>
+#include <SFML/Graphics/Texture.hpp>
+#include <SFML/Graphics/Image.hpp>
+#include <SFML/Graphics/RenderWindow.hpp>
+#include <SFML/Graphics/PixelBuffer.hpp>
+#include <SFML/Graphics/TextureSaver.hpp>
+#include <cstring>
+
+
+namespace sf
+{
+////////////////////////////////////////////////////////////
+ReadbackRequest::ReadbackRequest() :
+m_buffer   (NULL),
+m_fallback (),
+m_mapped   (NULL),
+m_size     (0, 0),
+m_topRow   (0),
+m_pitch    (0),
+m_isAlpha  (false),
+m_isStarted(false)
+{
+}
+
+
+////////////////////////////////////////////////////////////
+ReadbackRequest::~ReadbackRequest()
+{
+    release();
+    delete m_buffer;
+}
+
+
+////////////////////////////////////////////////////////////
+bool ReadbackRequest::start(const Texture& texture)
+{
+    if (!texture.m_texture)
+        return false;
+
+    ensureGlContext();
+
+    // The whole texture is read, including the padding if any
+    Vector2u actualSize = texture.m_actualSize;
+    int pitch = static_cast<int>(actualSize.x) * 4;
+    bool useBuffer = prepare(static_cast<std::size_t>(pitch) * actualSize.y);
+
+    // The color components of alpha textures are fixed when the pixels are accessed,
+    // in a copy since the pixel buffer can only be mapped for reading
+    m_isAlpha = (texture.m_format == Texture::Alpha);
+    if (m_isAlpha)
+        m_fallback.resize(static_cast<std::size_t>(pitch) * actualSize.y);
+
+    // Make sure that the current texture binding will be preserved
+    priv::TextureSaver save;
+
+    glCheck(glBindTexture(GL_TEXTURE_2D, texture.m_texture));
+    if (useBuffer)
+    {
+        m_buffer->bind();
+        glCheck(glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL));
+        m_buffer->unbind();
+        m_buffer->fence();
+    }
+    else
+    {
+        glCheck(glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, &m_fallback[0]));
+    }
+
+    // Handle the case where the pixels are flipped vertically
+    m_size   = texture.m_size;
+    m_topRow = texture.m_pixelsFlipped ? static_cast<std::size_t>(pitch) * (m_size.y - 1) : 0;
+    m_pitch  = texture.m_pixelsFlipped ? -pitch : pitch;
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+bool ReadbackRequest::start(const RenderWindow& window)
+{
+    // Make sure that the pending primitives are part of the read contents
+    const_cast<RenderWindow&>(window).flush();
+
+    if (!window.setActive())
+        return false;
+
+    Vector2u size = window.getSize();
+    if ((size.x == 0) || (size.y == 0))
+        return false;
+
+    int pitch = static_cast<int>(size.x) * 4;
+    bool useBuffer = prepare(static_cast<std::size_t>(pitch) * size.y);
+    m_isAlpha = false;
+
+    if (useBuffer)
+    {
+        m_buffer->bind();
+        glCheck(glReadPixels(0, 0, size.x, size.y, GL_RGBA, GL_UNSIGNED_BYTE, NULL));
+        m_buffer->unbind();
+        m_buffer->fence();
+    }
+    else
+    {
+        glCheck(glReadPixels(0, 0, size.x, size.y, GL_RGBA, GL_UNSIGNED_BYTE, &m_fallback[0]));
+    }
+
+    // OpenGL's origin is bottom while SFML's origin is top: the rows are read in reverse order
+    m_size   = size;
+    m_topRow = static_cast<std::size_t>(pitch) * (size.y - 1);
+    m_pitch  = -pitch;
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+bool ReadbackRequest::isStarted() const
+{
+    return m_isStarted;
+}
+
+
+////////////////////////////////////////////////////////////
+bool ReadbackRequest::isReady() const
+{
+    if (!m_isStarted)
+        return false;
+
+    return !m_buffer || m_mapped || m_buffer->isReady();
+}
+
+
+////////////////////////////////////////////////////////////
+Vector2u ReadbackRequest::getSize() const
+{
+    return m_size;
+}
+
+
+////////////////////////////////////////////////////////////
+const Uint8* ReadbackRequest::getPixels()
+{
+    if (!m_isStarted)
+        return NULL;
+
+    // Map the buffer; this waits for the graphics card if it hasn't finished writing yet
+    if (!m_mapped)
+    {
+        if (m_buffer)
+        {
+            ensureGlContext();
+            m_mapped = static_cast<const Uint8*>(m_buffer->map());
+        }
+        else
+        {
+            m_mapped = &m_fallback[0];
+        }
+
+        if (!m_mapped)
+            return NULL;
+
+        // Alpha textures are white, whatever their storage returns for the color components
+        if (m_isAlpha)
+        {
+            if (m_buffer)
+                std::memcpy(&m_fallback[0], m_mapped, m_fallback.size());
+
+            Uint8* row = &m_fallback[m_topRow];
+            for (unsigned int y = 0; y < m_size.y; ++y)
+            {
+                for (unsigned int x = 0; x < m_size.x; ++x)
+                    row[x * 4] = row[x * 4 + 1] = row[x * 4 + 2] = 255;
+                row += m_pitch;
+            }
+        }
+    }
+
+    return (m_isAlpha ? &m_fallback[0] : m_mapped) + m_topRow;
+}
+
+
+////////////////////////////////////////////////////////////
+int ReadbackRequest::getPitch() const
+{
+    return m_pitch;
+}
+
+
+////////////////////////////////////////////////////////////
+bool ReadbackRequest::copyToImage(Image& image)
+{
+    const Uint8* src = getPixels();
+    if (!src)
+        return false;
+
+    int rowSize = static_cast<int>(m_size.x) * 4;
+    if (m_pitch == rowSize)
+    {
+        // The rows are contiguous, we can use a direct copy
+        image.create(m_size.x, m_size.y, src);
+    }
+    else
+    {
+        // Copy the rows one by one, directly into the image
+        image.create(m_size.x, m_size.y);
+        Uint8* dst = &image.m_pixels[0];
+        for (unsigned int i = 0; i < m_size.y; ++i)
+        {
+            std::memcpy(dst, src, rowSize);
+            src += m_pitch;
+            dst += rowSize;
+        }
+    }
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+void ReadbackRequest::release()
+{
+    if (m_mapped && m_buffer)
+    {
+        ensureGlContext();
+        m_buffer->unmap();
+    }
+
+    m_mapped    = NULL;
+    m_isStarted = false;
+}
+
+
+////////////////////////////////////////////////////////////
+bool ReadbackRequest::isAvailable()
+{
+    return priv::PixelBuffer::isAvailable();
+}
+
+
+////////////////////////////////////////////////////////////
+bool ReadbackRequest::prepare(std::size_t size)
+{
+    release();
+    m_isStarted = true;
+
+    if (isAvailable())
+    {
+        if (!m_buffer)
+            m_buffer = new priv::PixelBuffer(priv::PixelBuffer::Download);
+
+        // Orphaning the storage lets the graphics card write to fresh memory
+        if (m_buffer->allocate(size))
+            return true;
+    }
+
+    // Pixel buffers are not supported: the pixels are read synchronously
+    delete m_buffer;
+    m_buffer = NULL;
+    m_fallback.resize(size);
+
+    return false;
+}
+
+} // namespace sf
@@ -73,4 +73,12 @@ Vector2f RectangleShape::getPoint(unsigned int index) const
     }
 }
 
+
+////////////////////////////////////////////////////////////
+bool RectangleShape::getGeometryParameters(Vector2f& parameters) const
+{
+    parameters = m_size;
+    return true;
+}
+
 } // namespace sf
@@ -0,0 +1,173 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2012 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Graphics/RenderCommandList.hpp>
+
+
+namespace
+{
+    // Check whether a primitive type is a list, whose draws can be merged
+    bool isListType(sf::PrimitiveType type)
+    {
+        return (type == sf::Points) || (type == sf::Lines) || (type == sf::Triangles) || (type == sf::Quads);
+    }
+
+    // Number of vertices of a primitive in a list type
+    unsigned int getPrimitiveSize(sf::PrimitiveType type)
+    {
+        switch (type)
+        {
+            default :
+            case sf::Points :    return 1;
+            case sf::Lines :     return 2;
+            case sf::Triangles : return 3;
+            case sf::Quads :     return 4;
+        }
+    }
+}
+
+
+namespace sf
+{
+////////////////////////////////////////////////////////////
+RenderCommandList::RenderCommandList() :
+m_vertices(),
+m_groups  ()
+{
+    initialize();
+
+    // Let the base class merge and pre-transform small draws, before they reach render()
+    setBatchingEnabled(true);
+}
+
+
+////////////////////////////////////////////////////////////
+void RenderCommandList::clear()
+{
+    // Discard the pending batch as well
+    flush();
+
+    m_vertices.clear();
+    m_groups.clear();
+}
+
+
+////////////////////////////////////////////////////////////
+unsigned int RenderCommandList::getGroupCount() const
+{
+    const_cast<RenderCommandList*>(this)->flush();
+
+    return static_cast<unsigned int>(m_groups.size());
+}
+
+
+////////////////////////////////////////////////////////////
+unsigned int RenderCommandList::getVertexCount() const
+{
+    const_cast<RenderCommandList*>(this)->flush();
+
+    return static_cast<unsigned int>(m_vertices.size());
+}
+
+
+////////////////////////////////////////////////////////////
+Vector2u RenderCommandList::getSize() const
+{
+    return Vector2u(0, 0);
+}
+
+
+////////////////////////////////////////////////////////////
+void RenderCommandList::draw(RenderTarget& target, RenderStates states) const
+{
+    // Record the pending batched primitives first
+    const_cast<RenderCommandList*>(this)->flush();
+
+    for (std::vector<Group>::const_iterator it = m_groups.begin(); it != m_groups.end(); ++it)
+    {
+        states.blendMode = it->blendMode;
+        states.texture   = it->texture;
+        states.shader    = it->shader;
+        target.draw(&m_vertices[it->firstVertex], it->vertexCount, it->type, states);
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void RenderCommandList::render(const Vertex* vertices, unsigned int vertexCount, const IndexArray* indices,
+                               PrimitiveType type, const RenderStates& states)
+{
+    unsigned int count = indices ? indices->getIndexCount() : vertexCount;
+
+    // Drop the incomplete trailing primitive of lists, so that it
+    // doesn't shift the primitives that may be appended after it
+    if (isListType(type))
+        count -= count % getPrimitiveSize(type);
+    if (count == 0)
+        return;
+
+    // Start a new group unless the primitives can be appended to the last one;
+    // strips and fans can't be merged, since they would be connected together
+    if (m_groups.empty()                              ||
+        !isListType(type)                             ||
+        (m_groups.back().type != type)                ||
+        (m_groups.back().blendMode != states.blendMode) ||
+        (m_groups.back().texture != states.texture)   ||
+        (m_groups.back().shader != states.shader))
+    {
+        Group group;
+        group.type        = type;
+        group.blendMode   = states.blendMode;
+        group.texture     = states.texture;
+        group.shader      = states.shader;
+        group.firstVertex = static_cast<unsigned int>(m_vertices.size());
+        group.vertexCount = 0;
+        m_groups.push_back(group);
+    }
+
+    // Copy the vertices, expanding the indices if any, and pre-transform them
+    std::size_t start = m_vertices.size();
+    m_vertices.resize(start + count);
+    if (indices)
+    {
+        for (unsigned int i = 0; i < count; ++i)
+            m_vertices[start + i] = vertices[(*indices)[i]];
+        vertices = &m_vertices[start];
+    }
+    states.transform.transformPoints(vertices, &m_vertices[start], count);
+
+    m_groups.back().vertexCount += count;
+}
+
+
+////////////////////////////////////////////////////////////
+bool RenderCommandList::activate(bool)
+{
+    return false;
+}
+
+} // namespace sf
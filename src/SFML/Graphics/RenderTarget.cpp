@@ -30,19 +30,97 @@
 #include <SFML/Graphics/Shader.hpp>
 #include <SFML/Graphics/Texture.hpp>
 #include <SFML/Graphics/VertexArray.hpp>
+#include <SFML/Graphics/VertexBuffer.hpp>
 #include <SFML/Graphics/GLCheck.hpp>
+#include <algorithm>
+#include <functional>
 #include <iostream>
 
 
+namespace
+{
+    // Get the list type that a primitive type is converted to when it's batched
+    sf::PrimitiveType getBatchType(sf::PrimitiveType type)
+    {
+        switch (type)
+        {
+            case sf::LinesStrip :     return sf::Lines;
+            case sf::TrianglesStrip : return sf::Triangles;
+            case sf::TrianglesFan :   return sf::Triangles;
+            default :                 return type;
+        }
+    }
+
+    // Get the number of vertices that make a single primitive of a list type
+    unsigned int getPrimitiveSize(sf::PrimitiveType type)
+    {
+        switch (type)
+        {
+            case sf::Lines :     return 2;
+            case sf::Triangles : return 3;
+            case sf::Quads :     return 4;
+            default :            return 1;
+        }
+    }
+
+    // Order deferred draws by layer, then by render states; within a layer, the
+    // draws that must preserve their order come last and all compare equal, so
+    // that they are painted over the sorted ones in their submission order
+    struct CommandLess
+    {
+        template <typename T>
+        bool operator ()(const T& left, const T& right) const
+        {
+            if (left.layer != right.layer)
+                return left.layer < right.layer;
+            if (left.preserveOrder != right.preserveOrder)
+                return right.preserveOrder;
+            if (left.preserveOrder)
+                return false;
+            if (left.shader != right.shader)
+                return std::less<const sf::Shader*>()(left.shader, right.shader);
+            if (left.textureId != right.textureId)
+                return left.textureId < right.textureId;
+            return left.blendMode < right.blendMode;
+        }
+    };
+
+    // Count the texture and blend mode changes needed to render a sequence of deferred draws
+    template <typename T>
+    void countStateChanges(const std::vector<T>& commands, unsigned int& textures, unsigned int& blendModes)
+    {
+        textures = 0;
+        blendModes = 0;
+        for (std::size_t i = 1; i < commands.size(); ++i)
+        {
+            if (commands[i].textureId != commands[i - 1].textureId)
+                textures++;
+            if (commands[i].blendMode != commands[i - 1].blendMode)
+                blendModes++;
+        }
+    }
+}
+
+
 namespace sf
 {
 ////////////////////////////////////////////////////////////
 RenderTarget::RenderTarget() :
-m_defaultView(),
-m_view       (),
-m_cache      ()
+m_defaultView  (),
+m_view         (),
+m_cache        (),
+m_batch        (),
+m_queue        (),
+m_quadIndices  (),
+m_quadTriangles(),
+m_statistics   ()
 {
     m_cache.glStatesSet = false;
+    m_batch.enabled = false;
+    m_queue.enabled = false;
+    m_queue.layer = 0;
+    m_queue.preserveOrder = false;
+    resetStatistics();
 }
 
 
@@ -55,6 +133,9 @@ RenderTarget::~RenderTarget()
 ////////////////////////////////////////////////////////////
 void RenderTarget::clear(const Color& color)
 {
+    // Pending primitives belong to the previous contents of the target
+    flush();
+
     if (activate(true))
     {
         glCheck(glClearColor(color.r / 255.f, color.g / 255.f, color.b / 255.f, color.a / 255.f));
@@ -66,6 +147,9 @@ void RenderTarget::clear(const Color& color)
 ////////////////////////////////////////////////////////////
 void RenderTarget::setView(const View& view)
 {
+    // Pending primitives must be rendered with the view that was active when they were drawn
+    flush();
+
     m_view = view;
     m_cache.viewChanged = true;
 }
@@ -155,91 +239,161 @@ void RenderTarget::draw(const Vertex* vertices, unsigned int vertexCount,
     if (!vertices || (vertexCount == 0))
         return;
 
+    if (m_queue.enabled)
+        enqueue(vertices, vertexCount, NULL, type, states);
+    else
+        submit(vertices, vertexCount, NULL, type, states);
+}
+
+
+////////////////////////////////////////////////////////////
+void RenderTarget::draw(const Vertex* vertices, unsigned int vertexCount, const IndexArray& indices,
+                        PrimitiveType type, const RenderStates& states)
+{
+    // Nothing to draw?
+    if (!vertices || (vertexCount == 0) || (indices.getIndexCount() == 0))
+        return;
+
+    if (m_queue.enabled)
+        enqueue(vertices, vertexCount, &indices, type, states);
+    else
+        submit(vertices, vertexCount, &indices, type, states);
+}
+
+
+////////////////////////////////////////////////////////////
+void RenderTarget::draw(const VertexBuffer& vertexBuffer, const RenderStates& states)
+{
+    draw(vertexBuffer, 0, vertexBuffer.getVertexCount(), states);
+}
+
+
+////////////////////////////////////////////////////////////
+void RenderTarget::draw(const VertexBuffer& vertexBuffer, unsigned int firstVertex,
+                        unsigned int vertexCount, const RenderStates& states)
+{
+    // Nothing to draw?
+    if (!vertexBuffer.getNativeHandle() || (vertexCount == 0))
+        return;
+
+    // Clamp the range to the size of the buffer
+    if (firstVertex >= vertexBuffer.getVertexCount())
+        return;
+    if (firstVertex + vertexCount > vertexBuffer.getVertexCount())
+        vertexCount = vertexBuffer.getVertexCount() - firstVertex;
+
+    // Pending primitives must be rendered first, to preserve the drawing order
+    flush();
+
     if (activate(true))
     {
         // First set the persistent OpenGL states if it's the very first call
         if (!m_cache.glStatesSet)
             resetGLStates();
 
-        // Check if the vertex count is low enough so that we can pre-transform them
-        bool useVertexCache = (vertexCount <= StatesCache::VertexCacheSize);
-        if (useVertexCache)
-        {
-            // Pre-transform the vertices and store them into the vertex cache
-            for (unsigned int i = 0; i < vertexCount; ++i)
-            {
-                Vertex& vertex = m_cache.vertexCache[i];
-                vertex.position = states.transform * vertices[i].position;
-                vertex.color = vertices[i].color;
-                vertex.texCoords = vertices[i].texCoords;
-            }
+        setupDraw(false, states);
 
-            // Since vertices are transformed, we must use an identity transform to render them
-            if (!m_cache.useVertexCache)
-                applyTransform(Transform::Identity);
-        }
-        else
-        {
-            applyTransform(states.transform);
-        }
+        // Make the vertex pointers refer to the buffer instead of the system memory;
+        // they start at the first vertex to draw, so that quads can be indexed from 0
+        const char* data = static_cast<const char*>(NULL) + firstVertex * sizeof(Vertex);
+        glCheck(glBindBufferARB(GL_ARRAY_BUFFER_ARB, vertexBuffer.getNativeHandle()));
+        glCheck(glVertexPointer(2, GL_FLOAT, sizeof(Vertex), data + 0));
+        glCheck(glColorPointer(4, GL_UNSIGNED_BYTE, sizeof(Vertex), data + 8));
+        glCheck(glTexCoordPointer(2, GL_FLOAT, sizeof(Vertex), data + 12));
 
-        // Apply the view
-        if (m_cache.viewChanged)
-            applyCurrentView();
+        drawPrimitives(vertexBuffer.getPrimitiveType(), 0, vertexCount);
 
-        // Apply the blend mode
-        if (states.blendMode != m_cache.lastBlendMode)
-            applyBlendMode(states.blendMode);
+        // Client-side arrays require the buffer binding to be 0
+        glCheck(glBindBufferARB(GL_ARRAY_BUFFER_ARB, 0));
 
-        // Apply the texture
-        Uint64 textureId = states.texture ? states.texture->m_cacheId : 0;
-        if (textureId != m_cache.lastTextureId)
-            applyTexture(states.texture);
+        // The pointers now refer to the buffer, they must be set again for the next draw
+        m_cache.lastVertexData = NULL;
+        m_cache.useVertexCache = false;
+    }
+}
 
-        // Apply the shader
-        if (states.shader)
-            applyShader(states.shader);
 
-        // If we pre-transform the vertices, we must use our internal vertex cache
-        if (useVertexCache)
-        {
-            // ... and if we already used it previously, we don't need to set the pointers again
-            if (!m_cache.useVertexCache)
-                vertices = m_cache.vertexCache;
-            else
-                vertices = NULL;
-        }
+////////////////////////////////////////////////////////////
+void RenderTarget::setBatchingEnabled(bool enabled)
+{
+    if (!enabled)
+        flush();
 
-        // Setup the pointers to the vertices' components
-        if (vertices)
-        {
-            const char* data = reinterpret_cast<const char*>(vertices);
-            glCheck(glVertexPointer(2, GL_FLOAT, sizeof(Vertex), data + 0));
-            glCheck(glColorPointer(4, GL_UNSIGNED_BYTE, sizeof(Vertex), data + 8));
-            glCheck(glTexCoordPointer(2, GL_FLOAT, sizeof(Vertex), data + 12));
-        }
+    m_batch.enabled = enabled;
+}
 
-        // Find the OpenGL primitive type
-        static const GLenum modes[] = {GL_POINTS, GL_LINES, GL_LINE_STRIP, GL_TRIANGLES,
-                                       GL_TRIANGLE_STRIP, GL_TRIANGLE_FAN, GL_QUADS};
-        GLenum mode = modes[type];
 
-        // Draw the primitives
-        glCheck(glDrawArrays(mode, 0, vertexCount));
+////////////////////////////////////////////////////////////
+bool RenderTarget::isBatchingEnabled() const
+{
+    return m_batch.enabled;
+}
 
-        // Unbind the shader, if any
-        if (states.shader)
-            applyShader(NULL);
 
-        // Update the cache
-        m_cache.useVertexCache = useVertexCache;
-    }
+////////////////////////////////////////////////////////////
+void RenderTarget::setDeferredEnabled(bool enabled)
+{
+    if (!enabled)
+        flush();
+
+    m_queue.enabled = enabled;
+}
+
+
+////////////////////////////////////////////////////////////
+bool RenderTarget::isDeferredEnabled() const
+{
+    return m_queue.enabled;
+}
+
+
+////////////////////////////////////////////////////////////
+void RenderTarget::setDrawLayer(int layer, bool preserveOrder)
+{
+    m_queue.layer = layer;
+    m_queue.preserveOrder = preserveOrder;
+}
+
+
+////////////////////////////////////////////////////////////
+int RenderTarget::getDrawLayer() const
+{
+    return m_queue.layer;
+}
+
+
+////////////////////////////////////////////////////////////
+void RenderTarget::flush()
+{
+    // The queue feeds the batch, so it must be flushed first
+    flushQueue();
+    flushBatch();
+}
+
+
+////////////////////////////////////////////////////////////
+const RenderTarget::Statistics& RenderTarget::getStatistics() const
+{
+    return m_statistics;
+}
+
+
+////////////////////////////////////////////////////////////
+void RenderTarget::resetStatistics()
+{
+    m_statistics.drawCalls           = 0;
+    m_statistics.mergedDraws         = 0;
+    m_statistics.textureBindsAvoided = 0;
+    m_statistics.blendChangesAvoided = 0;
 }
 
 
 ////////////////////////////////////////////////////////////
 void RenderTarget::pushGLStates()
 {
+    // Pending primitives must be rendered with the states that were active when they were drawn
+    flush();
+
     if (activate(true))
     {
         glCheck(glPushClientAttrib(GL_CLIENT_ALL_ATTRIB_BITS));
@@ -259,8 +413,15 @@ void RenderTarget::pushGLStates()
 ////////////////////////////////////////////////////////////
 void RenderTarget::popGLStates()
 {
+    flush();
+
     if (activate(true))
     {
+        // The current program is not part of the saved attributes, and our
+        // shader must not leak into the caller's OpenGL code
+        if (m_cache.lastShaderId)
+            applyShader(NULL);
+
         glCheck(glMatrixMode(GL_PROJECTION));
         glCheck(glPopMatrix());
         glCheck(glMatrixMode(GL_MODELVIEW));
@@ -276,6 +437,8 @@ void RenderTarget::popGLStates()
 ////////////////////////////////////////////////////////////
 void RenderTarget::resetGLStates()
 {
+    flush();
+
     if (activate(true))
     {
         // Make sure that GLEW is initialized
@@ -292,6 +455,8 @@ void RenderTarget::resetGLStates()
         glCheck(glEnableClientState(GL_VERTEX_ARRAY));
         glCheck(glEnableClientState(GL_COLOR_ARRAY));
         glCheck(glEnableClientState(GL_TEXTURE_COORD_ARRAY));
+        if (VertexBuffer::isAvailable())
+            glCheck(glBindBufferARB(GL_ARRAY_BUFFER_ARB, 0));
         m_cache.glStatesSet = true;
 
         // Apply the default SFML states
@@ -300,6 +465,9 @@ void RenderTarget::resetGLStates()
         applyTexture(NULL);
         if (Shader::isAvailable())
             applyShader(NULL);
+        for (unsigned int i = 0; i < StatesCache::TextureUnitCount; ++i)
+            m_cache.lastUnitTextureIds[i] = 0;
+        m_cache.lastVertexData = NULL;
         m_cache.useVertexCache = false;
 
         // Set the default view
@@ -320,6 +488,356 @@ void RenderTarget::initialize()
 }
 
 
+////////////////////////////////////////////////////////////
+void RenderTarget::addToBatch(const Vertex* vertices, unsigned int vertexCount, const IndexArray* indices,
+                              PrimitiveType type, const RenderStates& states)
+{
+    PrimitiveType batchType = getBatchType(type);
+    Uint64 textureId = states.texture ? states.texture->m_cacheId : 0;
+
+    // Start a new batch if the states are not compatible with the current one
+    if (!m_batch.vertices.empty())
+    {
+        if ((batchType         != m_batch.type)      ||
+            (states.blendMode  != m_batch.blendMode) ||
+            (textureId         != m_batch.textureId) ||
+            (states.shader     != m_batch.shader))
+        {
+            flushBatch();
+        }
+        else
+        {
+            m_statistics.mergedDraws++;
+        }
+    }
+
+    if (m_batch.vertices.empty())
+    {
+        m_batch.type      = batchType;
+        m_batch.blendMode = states.blendMode;
+        m_batch.texture   = states.texture;
+        m_batch.textureId = textureId;
+        m_batch.shader    = states.shader;
+    }
+
+    // Indexed primitives are expanded, so that the batch only contains plain vertices
+    const Transform& transform = states.transform;
+    std::size_t start = m_batch.vertices.size();
+    unsigned int count = indices ? indices->getIndexCount() : vertexCount;
+
+    if (batchType == type)
+    {
+        // List type: drop the incomplete trailing primitive, if any, so that it
+        // doesn't shift the primitives that will be appended after it
+        count -= count % getPrimitiveSize(type);
+
+        if (count == 0)
+            return;
+
+        m_batch.vertices.resize(start + count);
+        if (indices)
+        {
+            for (unsigned int i = 0; i < count; ++i)
+                m_batch.vertices[start + i] = vertices[(*indices)[i]];
+            vertices = &m_batch.vertices[start];
+        }
+        transform.transformPoints(vertices, &m_batch.vertices[start], count);
+    }
+    else
+    {
+        // Strip or fan: convert it to the equivalent list of primitives
+        unsigned int first = (type == LinesStrip) ? 1 : 2;
+        unsigned int size  = (type == LinesStrip) ? 2 : 3;
+        if (count <= first)
+            return;
+
+        m_batch.vertices.reserve(start + (count - first) * size);
+        for (unsigned int i = first; i < count; ++i)
+        {
+            unsigned int positions[3];
+            switch (type)
+            {
+                default :
+                case LinesStrip :     positions[0] = i - 1; positions[1] = i;                         break;
+                case TrianglesStrip : positions[0] = i - 2; positions[1] = i - 1; positions[2] = i;   break;
+                case TrianglesFan :   positions[0] = 0;     positions[1] = i - 1; positions[2] = i;   break;
+            }
+
+            for (unsigned int j = 0; j < size; ++j)
+                m_batch.vertices.push_back(vertices[indices ? (*indices)[positions[j]] : positions[j]]);
+        }
+
+        // Transform all the new vertices at once
+        Vertex* added = &m_batch.vertices[start];
+        transform.transformPoints(added, added, m_batch.vertices.size() - start);
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void RenderTarget::submit(const Vertex* vertices, unsigned int vertexCount, const IndexArray* indices,
+                          PrimitiveType type, const RenderStates& states)
+{
+    // Small enough primitives are accumulated into the batch, if enabled
+    unsigned int count = indices ? indices->getIndexCount() : vertexCount;
+    if (m_batch.enabled && (count <= Batch::MaxDrawSize))
+    {
+        addToBatch(vertices, vertexCount, indices, type, states);
+        return;
+    }
+
+    // Pending primitives must be rendered first, to preserve the drawing order
+    flushBatch();
+
+    render(vertices, vertexCount, indices, type, states);
+}
+
+
+////////////////////////////////////////////////////////////
+void RenderTarget::enqueue(const Vertex* vertices, unsigned int vertexCount, const IndexArray* indices,
+                           PrimitiveType type, const RenderStates& states)
+{
+    Command command;
+    command.layer         = m_queue.layer;
+    command.preserveOrder = m_queue.preserveOrder;
+    command.type          = type;
+    command.blendMode     = states.blendMode;
+    command.texture       = states.texture;
+    command.textureId     = states.texture ? states.texture->m_cacheId : 0;
+    command.shader        = states.shader;
+    command.firstVertex   = static_cast<unsigned int>(m_queue.vertices.size());
+    command.vertexCount   = indices ? indices->getIndexCount() : vertexCount;
+
+    // Copy the vertices, expanding the indices if any, and pre-transform them:
+    // the source array and the transform may not exist anymore when the queue is flushed
+    std::size_t start = m_queue.vertices.size();
+    m_queue.vertices.resize(start + command.vertexCount);
+    if (indices)
+    {
+        for (unsigned int i = 0; i < command.vertexCount; ++i)
+            m_queue.vertices[start + i] = vertices[(*indices)[i]];
+        vertices = &m_queue.vertices[start];
+    }
+    states.transform.transformPoints(vertices, &m_queue.vertices[start], command.vertexCount);
+
+    m_queue.commands.push_back(command);
+}
+
+
+////////////////////////////////////////////////////////////
+void RenderTarget::flushQueue()
+{
+    if (m_queue.commands.empty())
+        return;
+
+    // Detach the draws from the queue before submitting them, so that nested flushes find it empty
+    std::vector<Command> commands;
+    std::vector<Vertex> vertices;
+    commands.swap(m_queue.commands);
+    vertices.swap(m_queue.vertices);
+
+    // Sort the draws, and count how many state changes it saved
+    unsigned int texturesBefore, blendModesBefore, texturesAfter, blendModesAfter;
+    countStateChanges(commands, texturesBefore, blendModesBefore);
+    std::stable_sort(commands.begin(), commands.end(), CommandLess());
+    countStateChanges(commands, texturesAfter, blendModesAfter);
+
+    if (texturesAfter < texturesBefore)
+        m_statistics.textureBindsAvoided += texturesBefore - texturesAfter;
+    if (blendModesAfter < blendModesBefore)
+        m_statistics.blendChangesAvoided += blendModesBefore - blendModesAfter;
+
+    // Submit them; they are already transformed
+    for (std::vector<Command>::const_iterator it = commands.begin(); it != commands.end(); ++it)
+    {
+        RenderStates states(it->blendMode, Transform::Identity, it->texture, it->shader);
+        submit(&vertices[it->firstVertex], it->vertexCount, NULL, it->type, states);
+    }
+
+    // Give the memory back to the queue so that it can be reused
+    commands.clear();
+    vertices.clear();
+    commands.swap(m_queue.commands);
+    vertices.swap(m_queue.vertices);
+}
+
+
+////////////////////////////////////////////////////////////
+void RenderTarget::flushBatch()
+{
+    if (m_batch.vertices.empty())
+        return;
+
+    // Detach the vertices from the batch before rendering them, so that
+    // a nested call to flush (resetGLStates on the first draw) finds it empty
+    std::vector<Vertex> vertices;
+    vertices.swap(m_batch.vertices);
+
+    RenderStates states(m_batch.blendMode, Transform::Identity, m_batch.texture, m_batch.shader);
+    render(&vertices[0], static_cast<unsigned int>(vertices.size()), NULL, m_batch.type, states);
+
+    // Give the memory back to the batch so that it can be reused
+    vertices.clear();
+    vertices.swap(m_batch.vertices);
+}
+
+
+////////////////////////////////////////////////////////////
+void RenderTarget::render(const Vertex* vertices, unsigned int vertexCount, const IndexArray* indices,
+                          PrimitiveType type, const RenderStates& states)
+{
+    if (activate(true))
+    {
+        // First set the persistent OpenGL states if it's the very first call
+        if (!m_cache.glStatesSet)
+            resetGLStates();
+
+        // Check if the vertex count is low enough so that we can pre-transform them
+        bool useVertexCache = !indices && (vertexCount <= StatesCache::VertexCacheSize);
+        if (useVertexCache)
+        {
+            // Pre-transform the vertices and store them into the vertex cache
+            states.transform.transformPoints(vertices, m_cache.vertexCache, vertexCount);
+        }
+
+        setupDraw(useVertexCache, states);
+
+        // If we pre-transform the vertices, we must use our internal vertex cache
+        if (useVertexCache)
+            vertices = m_cache.vertexCache;
+
+        // Setup the pointers to the vertices' components; the arrays are read
+        // when the primitives are drawn, so if they didn't move the pointers are still valid
+        if (vertices != m_cache.lastVertexData)
+        {
+            const char* data = reinterpret_cast<const char*>(vertices);
+            glCheck(glVertexPointer(2, GL_FLOAT, sizeof(Vertex), data + 0));
+            glCheck(glColorPointer(4, GL_UNSIGNED_BYTE, sizeof(Vertex), data + 8));
+            glCheck(glTexCoordPointer(2, GL_FLOAT, sizeof(Vertex), data + 12));
+            m_cache.lastVertexData = vertices;
+        }
+
+        if (indices)
+            drawIndexedPrimitives(type, *indices);
+        else
+            drawPrimitives(type, 0, vertexCount);
+
+        // Update the cache
+        m_cache.useVertexCache = useVertexCache;
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void RenderTarget::setupDraw(bool useVertexCache, const RenderStates& states)
+{
+    // Since pre-transformed vertices are rendered with an identity transform,
+    // the transform needs to be set only if we didn't already use the vertex cache
+    if (useVertexCache)
+    {
+        if (!m_cache.useVertexCache)
+            applyTransform(Transform::Identity);
+    }
+    else
+    {
+        applyTransform(states.transform);
+    }
+
+    // Apply the view
+    if (m_cache.viewChanged)
+        applyCurrentView();
+
+    // Apply the blend mode
+    if (states.blendMode != m_cache.lastBlendMode)
+        applyBlendMode(states.blendMode);
+
+    // Apply the texture
+    Uint64 textureId = states.texture ? states.texture->m_cacheId : 0;
+    if (textureId != m_cache.lastTextureId)
+        applyTexture(states.texture);
+
+    // Apply the shader; it stays bound after the draw, so that consecutive
+    // draws with the same shader don't have to bind it again
+    if (states.shader || m_cache.lastShaderId)
+        applyShader(states.shader);
+}
+
+
+////////////////////////////////////////////////////////////
+void RenderTarget::drawPrimitives(PrimitiveType type, unsigned int firstVertex, unsigned int vertexCount)
+{
+    if (type == Quads)
+    {
+        // GL_QUADS is deprecated: render each quad as two triangles sharing
+        // their diagonal, with a (lazily extended) common index pattern
+        unsigned int quadCount = vertexCount / 4;
+        for (unsigned int i = m_quadIndices.getIndexCount() / 6; i < quadCount; ++i)
+        {
+            m_quadIndices.append(i * 4 + 0);
+            m_quadIndices.append(i * 4 + 1);
+            m_quadIndices.append(i * 4 + 2);
+            m_quadIndices.append(i * 4 + 0);
+            m_quadIndices.append(i * 4 + 2);
+            m_quadIndices.append(i * 4 + 3);
+        }
+
+        GLenum indexType = (m_quadIndices.getType() == IndexArray::Index16) ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+        glCheck(glDrawElements(GL_TRIANGLES, quadCount * 6, indexType, m_quadIndices.getData()));
+    }
+    else
+    {
+        // Find the OpenGL primitive type
+        static const GLenum modes[] = {GL_POINTS, GL_LINES, GL_LINE_STRIP, GL_TRIANGLES,
+                                       GL_TRIANGLE_STRIP, GL_TRIANGLE_FAN};
+        GLenum mode = modes[type];
+
+        // Draw the primitives
+        glCheck(glDrawArrays(mode, firstVertex, vertexCount));
+    }
+
+    m_statistics.drawCalls++;
+}
+
+
+////////////////////////////////////////////////////////////
+void RenderTarget::drawIndexedPrimitives(PrimitiveType type, const IndexArray& indices)
+{
+    if (type == Quads)
+    {
+        // GL_QUADS is deprecated: convert each quad to two triangles, in
+        // an array that keeps its memory from one draw to the next
+        m_quadTriangles.clear();
+        for (unsigned int i = 0; i + 3 < indices.getIndexCount(); i += 4)
+        {
+            m_quadTriangles.append(indices[i + 0]);
+            m_quadTriangles.append(indices[i + 1]);
+            m_quadTriangles.append(indices[i + 2]);
+            m_quadTriangles.append(indices[i + 0]);
+            m_quadTriangles.append(indices[i + 2]);
+            m_quadTriangles.append(indices[i + 3]);
+        }
+
+        GLenum indexType = (m_quadTriangles.getType() == IndexArray::Index16) ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+        if (m_quadTriangles.getIndexCount() > 0)
+            glCheck(glDrawElements(GL_TRIANGLES, m_quadTriangles.getIndexCount(), indexType, m_quadTriangles.getData()));
+    }
+    else
+    {
+        GLenum indexType = (indices.getType() == IndexArray::Index16) ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+
+        // Find the OpenGL primitive type
+        static const GLenum modes[] = {GL_POINTS, GL_LINES, GL_LINE_STRIP, GL_TRIANGLES,
+                                       GL_TRIANGLE_STRIP, GL_TRIANGLE_FAN};
+        GLenum mode = modes[type];
+
+        // Draw the primitives
+        glCheck(glDrawElements(mode, indices.getIndexCount(), indexType, indices.getData()));
+    }
+
+    m_statistics.drawCalls++;
+}
+
+
 ////////////////////////////////////////////////////////////
 void RenderTarget::applyCurrentView()
 {
@@ -399,10 +917,52 @@ void RenderTarget::applyTexture(const Texture* texture)
 ////////////////////////////////////////////////////////////
 void RenderTarget::applyShader(const Shader* shader)
 {
-    if (shader)
-        shader->bind();
-    else
+    if (!shader)
+    {
         glCheck(glUseProgramObjectARB(0));
+        m_cache.lastShaderId = 0;
+        return;
+    }
+
+    // Bind the program and assign the texture units to its sampler variables,
+    // unless it's already done (they are part of the program's state)
+    if (shader->m_cacheId != m_cache.lastShaderId)
+    {
+        glCheck(glUseProgramObjectARB(shader->m_shaderProgram));
+
+        GLint unit = 1;
+        for (Shader::TextureTable::const_iterator it = shader->m_textures.begin(); it != shader->m_textures.end(); ++it)
+            glCheck(glUniform1iARB(it->first, unit++));
+
+        if (shader->m_currentTexture != -1)
+            glCheck(glUniform1iARB(shader->m_currentTexture, 0));
+
+        m_cache.lastShaderId = shader->m_cacheId;
+    }
+
+    // Upload the parameters that changed since the last draw
+    shader->uploadParameters();
+
+    // Bind the textures whose unit doesn't hold them already
+    unsigned int unit = 1;
+    bool unitChanged = false;
+    for (Shader::TextureTable::const_iterator it = shader->m_textures.begin(); it != shader->m_textures.end(); ++it, ++unit)
+    {
+        Uint64 textureId = it->second->m_cacheId;
+        if ((unit >= StatesCache::TextureUnitCount) || (m_cache.lastUnitTextureIds[unit] != textureId))
+        {
+            glCheck(glActiveTextureARB(GL_TEXTURE0_ARB + unit));
+            it->second->bind();
+            unitChanged = true;
+
+            if (unit < StatesCache::TextureUnitCount)
+                m_cache.lastUnitTextureIds[unit] = textureId;
+        }
+    }
+
+    // Make sure that the texture unit which is left active is the number 0
+    if (unitChanged)
+        glCheck(glActiveTextureARB(GL_TEXTURE0_ARB));
 }
 
 } // namespace sf
@@ -436,10 +996,34 @@ void RenderTarget::applyShader(const Shader* shader)
 //   identifier system to ensure consistent caching.
 //
 // * Shader
-//   Shaders are very hard to optimize, because they have
-//   parameters that can be hard (if not impossible) to track,
-//   like matrices or textures. The only optimization that we
-//   do is that we avoid setting a null shader if there was
-//   already none for the previous draw.
+//   Shaders are given a unique identifier too, which changes
+//   whenever their program is recompiled or their texture units
+//   are assigned differently. The program stays bound after a
+//   draw, and is bound again (with its sampler variables) only
+//   when the identifier changes. The textures of the shader are
+//   cached per texture unit, with their own identifier. Uniform
+//   values are program state: sf::Shader stages them and only
+//   uploads the ones that changed when it is bound.
+//
+// * Vertex arrays
+//   The address given to the gl*Pointer functions is cached:
+//   client arrays are read when the primitives are drawn, so the
+//   pointers remain valid as long as the vertices don't move.
+//
+// * Batching
+//   When batching is enabled, small primitives are transformed
+//   on the CPU and accumulated as long as their texture, blend
+//   mode, shader and (list) primitive type don't change. The
+//   whole batch is then rendered with an identity transform
+//   and a single draw call. Since the texture pointer may be
+//   modified before the batch is flushed, its unique identifier
+//   is stored at the time the primitives are batched.
+//
+// * Deferred rendering
+//   Deferred draws are pre-transformed and queued; when the
+//   queue is flushed it is stable-sorted by layer, shader,
+//   texture and blend mode, and submitted to the batch. Draws
+//   that share their states are then consecutive, which saves
+//   state changes and lets the batch merge them.
 // 
 ////////////////////////////////////////////////////////////
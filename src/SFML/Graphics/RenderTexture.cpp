@@ -109,6 +109,9 @@ bool RenderTexture::setActive(bool active)
 ////////////////////////////////////////////////////////////
 void RenderTexture::display()
 {
+    // Render the pending primitives, if any
+    flush();
+
     // Update the target texture
     if (setActive(true))
     {
@@ -78,6 +78,9 @@ Vector2u RenderWindow::getSize() const
 ////////////////////////////////////////////////////////////
 Image RenderWindow::capture() const
 {
+    // Make sure that the pending primitives are part of the captured contents
+    const_cast<RenderWindow*>(this)->flush();
+
     Image image;
     if (setActive())
     {
@@ -114,4 +117,12 @@ void RenderWindow::onResize()
     setView(getView());
 }
 
+
+////////////////////////////////////////////////////////////
+void RenderWindow::onDisplay()
+{
+    // Render the pending primitives, if any
+    flush();
+}
+
 } // namespace sf
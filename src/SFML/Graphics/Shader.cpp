@@ -30,13 +30,27 @@
 #include <SFML/Graphics/Texture.hpp>
 #include <SFML/Graphics/GLCheck.hpp>
 #include <SFML/System/InputStream.hpp>
+#include <SFML/System/Mutex.hpp>
+#include <SFML/System/Lock.hpp>
 #include <SFML/System/Err.hpp>
 #include <fstream>
 #include <vector>
+#include <cstring>
 
 
 namespace
 {
+    // Thread-safe unique identifier generator,
+    // is used for states cache (see RenderTarget)
+    sf::Uint64 getUniqueId()
+    {
+        static sf::Uint64 id = 1; // start at 1, zero is "no shader"
+        static sf::Mutex mutex;
+
+        sf::Lock lock(mutex);
+        return id++;
+    }
+
     // Retrieve the maximum number of texture units available
     GLint getMaxTextureUnits()
     {
@@ -93,8 +107,13 @@ Shader::CurrentTextureType Shader::CurrentTexture;
 
 ////////////////////////////////////////////////////////////
 Shader::Shader() :
-m_shaderProgram (0),
-m_currentTexture(-1)
+m_shaderProgram    (0),
+m_currentTexture   (-1),
+m_textures         (),
+m_locations        (),
+m_parameters       (),
+m_parametersChanged(false),
+m_cacheId          (getUniqueId())
 {
 }
 
@@ -218,96 +237,32 @@ bool Shader::loadFromStream(InputStream& vertexShaderStream, InputStream& fragme
 ////////////////////////////////////////////////////////////
 void Shader::setParameter(const std::string& name, float x)
 {
-    if (m_shaderProgram)
-    {
-        ensureGlContext();
-
-        // Enable program
-        GLhandleARB program = glGetHandleARB(GL_PROGRAM_OBJECT_ARB);
-        glCheck(glUseProgramObjectARB(m_shaderProgram));
-
-        // Get parameter location and assign it new values
-        GLint location = glGetUniformLocationARB(m_shaderProgram, name.c_str());
-        if (location != -1)
-            glCheck(glUniform1fARB(location, x));
-        else
-            err() << "Parameter \"" << name << "\" not found in shader" << std::endl;
-
-        // Disable program
-        glCheck(glUseProgramObjectARB(program));
-    }
+    float values[] = {x};
+    stageParameter(name, values, 1);
 }
 
 
 ////////////////////////////////////////////////////////////
 void Shader::setParameter(const std::string& name, float x, float y)
 {
-    if (m_shaderProgram)
-    {
-        ensureGlContext();
-
-        // Enable program
-        GLhandleARB program = glGetHandleARB(GL_PROGRAM_OBJECT_ARB);
-        glCheck(glUseProgramObjectARB(m_shaderProgram));
-
-        // Get parameter location and assign it new values
-        GLint location = glGetUniformLocationARB(m_shaderProgram, name.c_str());
-        if (location != -1)
-            glCheck(glUniform2fARB(location, x, y));
-        else
-            err() << "Parameter \"" << name << "\" not found in shader" << std::endl;
-
-        // Disable program
-        glCheck(glUseProgramObjectARB(program));
-    }
+    float values[] = {x, y};
+    stageParameter(name, values, 2);
 }
 
 
 ////////////////////////////////////////////////////////////
 void Shader::setParameter(const std::string& name, float x, float y, float z)
 {
-    if (m_shaderProgram)
-    {
-        ensureGlContext();
-
-        // Enable program
-        GLhandleARB program = glGetHandleARB(GL_PROGRAM_OBJECT_ARB);
-        glCheck(glUseProgramObjectARB(m_shaderProgram));
-
-        // Get parameter location and assign it new values
-        GLint location = glGetUniformLocationARB(m_shaderProgram, name.c_str());
-        if (location != -1)
-            glCheck(glUniform3fARB(location, x, y, z));
-        else
-            err() << "Parameter \"" << name << "\" not found in shader" << std::endl;
-
-        // Disable program
-        glCheck(glUseProgramObjectARB(program));
-    }
+    float values[] = {x, y, z};
+    stageParameter(name, values, 3);
 }
 
 
 ////////////////////////////////////////////////////////////
 void Shader::setParameter(const std::string& name, float x, float y, float z, float w)
 {
-    if (m_shaderProgram)
-    {
-        ensureGlContext();
-
-        // Enable program
-        GLhandleARB program = glGetHandleARB(GL_PROGRAM_OBJECT_ARB);
-        glCheck(glUseProgramObjectARB(m_shaderProgram));
-
-        // Get parameter location and assign it new values
-        GLint location = glGetUniformLocationARB(m_shaderProgram, name.c_str());
-        if (location != -1)
-            glCheck(glUniform4fARB(location, x, y, z, w));
-        else
-            err() << "Parameter \"" << name << "\" not found in shader" << std::endl;
-
-        // Disable program
-        glCheck(glUseProgramObjectARB(program));
-    }
+    float values[] = {x, y, z, w};
+    stageParameter(name, values, 4);
 }
 
 
@@ -335,24 +290,7 @@ void Shader::setParameter(const std::string& name, const Color& color)
 ////////////////////////////////////////////////////////////
 void Shader::setParameter(const std::string& name, const sf::Transform& transform)
 {
-    if (m_shaderProgram)
-    {
-        ensureGlContext();
-
-        // Enable program
-        GLhandleARB program = glGetHandleARB(GL_PROGRAM_OBJECT_ARB);
-        glCheck(glUseProgramObjectARB(m_shaderProgram));
-
-        // Get parameter location and assign it new values
-        GLint location = glGetUniformLocationARB(m_shaderProgram, name.c_str());
-        if (location != -1)
-            glCheck(glUniformMatrix4fvARB(location, 1, GL_FALSE, transform.getMatrix()));
-        else
-            err() << "Parameter \"" << name << "\" not found in shader" << std::endl;
-
-        // Disable program
-        glCheck(glUseProgramObjectARB(program));
-    }
+    stageParameter(name, transform.getMatrix(), 16);
 }
 
 
@@ -364,7 +302,7 @@ void Shader::setParameter(const std::string& name, const Texture& texture)
         ensureGlContext();
 
         // Find the location of the variable in the shader
-        int location = glGetUniformLocationARB(m_shaderProgram, name.c_str());
+        int location = getParameterLocation(name);
         if (location == -1)
         {
             err() << "Texture \"" << name << "\" not found in shader" << std::endl;
@@ -384,6 +322,9 @@ void Shader::setParameter(const std::string& name, const Texture& texture)
             }
 
             m_textures[location] = &texture;
+
+            // The texture units are assigned differently now
+            m_cacheId = getUniqueId();
         }
         else
         {
@@ -402,9 +343,12 @@ void Shader::setParameter(const std::string& name, CurrentTextureType)
         ensureGlContext();
 
         // Find the location of the variable in the shader
-        m_currentTexture = glGetUniformLocationARB(m_shaderProgram, name.c_str());
+        m_currentTexture = getParameterLocation(name);
         if (m_currentTexture == -1)
             err() << "Texture \"" << name << "\" not found in shader" << std::endl;
+
+        // The sampler variables must be set again
+        m_cacheId = getUniqueId();
     }
 }
 
@@ -419,6 +363,9 @@ void Shader::bind() const
         // Enable the program
         glCheck(glUseProgramObjectARB(m_shaderProgram));
 
+        // Upload the parameters that changed since the last bind
+        uploadParameters();
+
         // Bind the textures
         bindTextures();
 
@@ -463,6 +410,12 @@ bool Shader::compile(const char* vertexShaderCode, const char* fragmentShaderCod
 
     // Create the program
     m_shaderProgram = glCreateProgramObjectARB();
+    m_cacheId = getUniqueId();
+
+    // The locations and the values of the parameters belonged to the previous program
+    m_locations.clear();
+    m_parameters.clear();
+    m_parametersChanged = false;
 
     // Create the vertex shader if needed
     if (vertexShaderCode)
@@ -558,4 +511,79 @@ void Shader::bindTextures() const
     glCheck(glActiveTextureARB(GL_TEXTURE0_ARB));
 }
 
+
+////////////////////////////////////////////////////////////
+int Shader::getParameterLocation(const std::string& name)
+{
+    // Check the cache first
+    LocationTable::const_iterator it = m_locations.find(name);
+    if (it != m_locations.end())
+        return it->second;
+
+    // Not in cache, request the location from OpenGL; a missing
+    // variable is cached as well, so that it's not requested again
+    int location = glGetUniformLocationARB(m_shaderProgram, name.c_str());
+    m_locations.insert(std::make_pair(name, location));
+
+    return location;
+}
+
+
+////////////////////////////////////////////////////////////
+void Shader::stageParameter(const std::string& name, const float* values, int size)
+{
+    if (m_shaderProgram)
+    {
+        ensureGlContext();
+
+        // Get parameter location
+        int location = getParameterLocation(name);
+        if (location == -1)
+        {
+            err() << "Parameter \"" << name << "\" not found in shader" << std::endl;
+            return;
+        }
+
+        // Store the new value, unless it is the same as the current one
+        Parameter& parameter = m_parameters[location];
+        if ((parameter.size != size) || (std::memcmp(parameter.values, values, size * sizeof(float)) != 0))
+        {
+            parameter.size = size;
+            std::memcpy(parameter.values, values, size * sizeof(float));
+            parameter.changed = true;
+            m_parametersChanged = true;
+        }
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void Shader::uploadParameters() const
+{
+    if (!m_parametersChanged)
+        return;
+
+    for (ParameterTable::iterator it = m_parameters.begin(); it != m_parameters.end(); ++it)
+    {
+        Parameter& parameter = it->second;
+        if (parameter.changed)
+        {
+            const float* v = parameter.values;
+            switch (parameter.size)
+            {
+                case 1 :  glCheck(glUniform1fARB(it->first, v[0]));                     break;
+                case 2 :  glCheck(glUniform2fARB(it->first, v[0], v[1]));               break;
+                case 3 :  glCheck(glUniform3fARB(it->first, v[0], v[1], v[2]));         break;
+                case 4 :  glCheck(glUniform4fARB(it->first, v[0], v[1], v[2], v[3]));   break;
+                case 16 : glCheck(glUniformMatrix4fvARB(it->first, 1, GL_FALSE, v));    break;
+                default : break;
+            }
+
+            parameter.changed = false;
+        }
+    }
+
+    m_parametersChanged = false;
+}
+
 } // namespace sf
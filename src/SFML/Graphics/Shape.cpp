@@ -26,10 +26,12 @@
 // Headers
 ////////////////////////////////////////////////////////////
 #include <SFML/Graphics/Shape.hpp>
+#include <SFML/Graphics/ShapeGeometry.hpp>
 #include <SFML/Graphics/RenderTarget.hpp>
 #include <SFML/Graphics/Texture.hpp>
 #include <SFML/System/Err.hpp>
 #include <cmath>
+#include <typeinfo>
 
 
 namespace
@@ -51,6 +53,7 @@ namespace sf
 ////////////////////////////////////////////////////////////
 Shape::~Shape()
 {
+    priv::ShapeGeometry::release(m_geometry);
 }
 
 
@@ -122,7 +125,33 @@ const Color& Shape::getOutlineColor() const
 void Shape::setOutlineThickness(float thickness)
 {
     m_outlineThickness = thickness;
-    update(); // recompute everything because the whole shape must be offset
+
+    // The points don't change, only the outline must be recomputed
+    if (m_vertices.getVertexCount() == 0)
+    {
+        update();
+    }
+    else if (m_geometry)
+    {
+        // Take the outline of an identical shape, or compute it and share it
+        priv::ShapeGeometry::Key key = m_geometry->getKey();
+        key.outlineThickness = thickness;
+        const priv::ShapeGeometry* geometry = priv::ShapeGeometry::find(key);
+        if (geometry)
+        {
+            setGeometry(geometry);
+            copyOutline();
+        }
+        else
+        {
+            updateOutline();
+            m_geometry = priv::ShapeGeometry::insert(key, m_vertices, m_outlineVertices, m_insideBounds, m_bounds, m_geometry);
+        }
+    }
+    else
+    {
+        updateOutline();
+    }
 }
 
 
@@ -157,11 +186,51 @@ m_outlineThickness(0),
 m_vertices        (TrianglesFan),
 m_outlineVertices (TrianglesStrip),
 m_insideBounds    (),
-m_bounds          ()
+m_bounds          (),
+m_geometry        (NULL)
 {
 }
 
 
+////////////////////////////////////////////////////////////
+Shape::Shape(const Shape& copy) :
+Drawable          (copy),
+Transformable     (copy),
+m_texture         (copy.m_texture),
+m_textureRect     (copy.m_textureRect),
+m_fillColor       (copy.m_fillColor),
+m_outlineColor    (copy.m_outlineColor),
+m_outlineThickness(copy.m_outlineThickness),
+m_vertices        (copy.m_vertices),
+m_outlineVertices (copy.m_outlineVertices),
+m_insideBounds    (copy.m_insideBounds),
+m_bounds          (copy.m_bounds),
+m_geometry        (priv::ShapeGeometry::acquire(copy.m_geometry))
+{
+}
+
+
+////////////////////////////////////////////////////////////
+Shape& Shape::operator =(const Shape& right)
+{
+    // Share the geometry of the other shape before releasing ours, in case it's the same
+    setGeometry(priv::ShapeGeometry::acquire(right.m_geometry));
+
+    Transformable::operator =(right);
+    m_texture          = right.m_texture;
+    m_textureRect      = right.m_textureRect;
+    m_fillColor        = right.m_fillColor;
+    m_outlineColor     = right.m_outlineColor;
+    m_outlineThickness = right.m_outlineThickness;
+    m_vertices         = right.m_vertices;
+    m_outlineVertices  = right.m_outlineVertices;
+    m_insideBounds     = right.m_insideBounds;
+    m_bounds           = right.m_bounds;
+
+    return *this;
+}
+
+
 ////////////////////////////////////////////////////////////
 void Shape::update()
 {
@@ -171,9 +240,25 @@ void Shape::update()
     {
         m_vertices.resize(0);
         m_outlineVertices.resize(0);
+        setGeometry(NULL);
         return;
     }
 
+    // Take the geometry of an identical shape, if the derived class allows sharing it
+    Vector2f parameters;
+    bool shared = getGeometryParameters(parameters);
+    priv::ShapeGeometry::Key key(typeid(*this), parameters, count, m_outlineThickness);
+    if (shared)
+    {
+        const priv::ShapeGeometry* geometry = priv::ShapeGeometry::find(key);
+        if (geometry)
+        {
+            setGeometry(geometry);
+            copyGeometry();
+            return;
+        }
+    }
+
     m_vertices.resize(count + 2); // + 2 for center and repeated first point
 
     // Position
@@ -197,6 +282,19 @@ void Shape::update()
 
     // Outline
     updateOutline();
+
+    // Share the result with the identical shapes
+    if (shared)
+        m_geometry = priv::ShapeGeometry::insert(key, m_vertices, m_outlineVertices, m_insideBounds, m_bounds, m_geometry);
+    else
+        setGeometry(NULL);
+}
+
+
+////////////////////////////////////////////////////////////
+bool Shape::getGeometryParameters(Vector2f&) const
+{
+    return false;
 }
 
 
@@ -244,38 +342,61 @@ void Shape::updateOutline()
 {
     unsigned int count = m_vertices.getVertexCount() - 2;
     m_outlineVertices.resize((count + 1) * 2);
+    computeOutline(&m_vertices[1], count, m_outlineThickness, &m_outlineVertices[0]);
 
-    for (unsigned int i = 0; i < count; ++i)
-    {
-        unsigned int index = i + 1;
+    // Update outline colors
+    updateOutlineColors();
 
-        // Get the two segments shared by the current point
-        Vector2f p0 = (i == 0) ? m_vertices[count].position : m_vertices[index - 1].position;
-        Vector2f p1 = m_vertices[index].position;
-        Vector2f p2 = m_vertices[index + 1].position;
+    // Update the shape's bounds
+    m_bounds = m_outlineVertices.getBounds();
+}
 
-        // Compute their normal
-        Vector2f n1 = computeNormal(p0, p1);
-        Vector2f n2 = computeNormal(p1, p2);
 
-        // Combine them to get the extrusion direction
-        float factor = 1.f + (n1.x * n2.x + n1.y * n2.y);
-        Vector2f normal = -(n1 + n2) / factor;
+////////////////////////////////////////////////////////////
+void Shape::setGeometry(const priv::ShapeGeometry* geometry)
+{
+    priv::ShapeGeometry::release(m_geometry);
+    m_geometry = geometry;
+}
 
-        // Update the outline points
-        m_outlineVertices[i * 2 + 0].position = p1;
-        m_outlineVertices[i * 2 + 1].position = p1 + normal * m_outlineThickness;
-    }
 
-    // Duplicate the first point at the end, to close the outline
-    m_outlineVertices[count * 2 + 0].position = m_outlineVertices[0].position;
-    m_outlineVertices[count * 2 + 1].position = m_outlineVertices[1].position;
+////////////////////////////////////////////////////////////
+void Shape::copyGeometry()
+{
+    // Copy the fill positions
+    const std::vector<Vector2f>& points = m_geometry->getPoints();
+    m_vertices.resize(static_cast<unsigned int>(points.size()));
+    Vertex* vertices = &m_vertices[0];
+    for (std::size_t i = 0; i < points.size(); ++i)
+        vertices[i].position = points[i];
+    m_insideBounds = m_geometry->getInsideBounds();
+
+    // Color
+    updateFillColors();
+
+    // Texture coordinates
+    updateTexCoords();
+
+    // Outline
+    copyOutline();
+}
+
+
+////////////////////////////////////////////////////////////
+void Shape::copyOutline()
+{
+    // Copy the outline positions
+    const std::vector<Vector2f>& outline = m_geometry->getOutline();
+    m_outlineVertices.resize(static_cast<unsigned int>(outline.size()));
+    Vertex* vertices = &m_outlineVertices[0];
+    for (std::size_t i = 0; i < outline.size(); ++i)
+        vertices[i].position = outline[i];
 
     // Update outline colors
     updateOutlineColors();
 
     // Update the shape's bounds
-    m_bounds = m_outlineVertices.getBounds();
+    m_bounds = m_geometry->getBounds();
 }
 
 
@@ -286,4 +407,33 @@ void Shape::updateOutlineColors()
         m_outlineVertices[i].color = m_outlineColor;
 }
 
+
+////////////////////////////////////////////////////////////
+void Shape::computeOutline(const Vertex* points, unsigned int count, float thickness, Vertex* outline)
+{
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        // Get the two segments shared by the current point
+        Vector2f p0 = points[(i + count - 1) % count].position;
+        Vector2f p1 = points[i].position;
+        Vector2f p2 = points[(i + 1) % count].position;
+
+        // Compute their normal
+        Vector2f n1 = computeNormal(p0, p1);
+        Vector2f n2 = computeNormal(p1, p2);
+
+        // Combine them to get the extrusion direction
+        float factor = 1.f + (n1.x * n2.x + n1.y * n2.y);
+        Vector2f normal = -(n1 + n2) / factor;
+
+        // Update the outline points
+        outline[i * 2 + 0].position = p1;
+        outline[i * 2 + 1].position = p1 + normal * thickness;
+    }
+
+    // Duplicate the first point at the end, to close the outline
+    outline[count * 2 + 0].position = outline[0].position;
+    outline[count * 2 + 1].position = outline[1].position;
+}
+
 } // namespace sf
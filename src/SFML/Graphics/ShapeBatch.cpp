@@ -0,0 +1,193 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2012 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Graphics/ShapeBatch.hpp>
+#include <SFML/Graphics/Shape.hpp>
+#include <SFML/Graphics/RenderTarget.hpp>
+#include <cmath>
+
+
+namespace sf
+{
+////////////////////////////////////////////////////////////
+ShapeBatch::ShapeBatch() :
+m_vertices  (),
+m_points    (),
+m_strip     (),
+m_shapeCount(0)
+{
+}
+
+
+////////////////////////////////////////////////////////////
+void ShapeBatch::add(const Shape& shape)
+{
+    // The fill is a fan around the center of the shape (see sf::Shape::update)
+    unsigned int count = shape.m_vertices.getVertexCount();
+    if (count < 3)
+        return;
+
+    const Transform& transform = shape.getTransform();
+    m_strip.resize(count);
+    transform.transformPoints(&shape.m_vertices[0], &m_strip[0], count);
+
+    for (unsigned int i = 1; i + 1 < count; ++i)
+    {
+        m_vertices.push_back(m_strip[0]);
+        m_vertices.push_back(m_strip[i]);
+        m_vertices.push_back(m_strip[i + 1]);
+    }
+
+    // The outline is a triangle strip
+    unsigned int outlineCount = shape.m_outlineVertices.getVertexCount();
+    if ((shape.getOutlineThickness() != 0) && (outlineCount >= 3))
+    {
+        m_strip.resize(outlineCount);
+        transform.transformPoints(&shape.m_outlineVertices[0], &m_strip[0], outlineCount);
+        addStrip(&m_strip[0], outlineCount);
+    }
+
+    m_shapeCount++;
+}
+
+
+////////////////////////////////////////////////////////////
+void ShapeBatch::addRectangle(const FloatRect& rectangle, const Color& fillColor,
+                              float outlineThickness, const Color& outlineColor)
+{
+    // Same points as sf::RectangleShape, so that the outline is extruded the same way
+    m_points.resize(4);
+    m_points[0].position = Vector2f(rectangle.left, rectangle.top);
+    m_points[1].position = Vector2f(rectangle.left + rectangle.width, rectangle.top);
+    m_points[2].position = Vector2f(rectangle.left + rectangle.width, rectangle.top + rectangle.height);
+    m_points[3].position = Vector2f(rectangle.left, rectangle.top + rectangle.height);
+
+    addPoints(fillColor, outlineThickness, outlineColor);
+}
+
+
+////////////////////////////////////////////////////////////
+void ShapeBatch::addCircle(const Vector2f& center, float radius, const Color& fillColor,
+                           float outlineThickness, const Color& outlineColor, unsigned int pointCount)
+{
+    static const float pi = 3.141592654f;
+
+    // Same points as sf::CircleShape, relative to the center
+    m_points.resize(pointCount);
+    for (unsigned int i = 0; i < pointCount; ++i)
+    {
+        float angle = i * 2 * pi / pointCount - pi / 2;
+        m_points[i].position = Vector2f(center.x + std::cos(angle) * radius, center.y + std::sin(angle) * radius);
+    }
+
+    addPoints(fillColor, outlineThickness, outlineColor);
+}
+
+
+////////////////////////////////////////////////////////////
+void ShapeBatch::addPolygon(const Vector2f* points, unsigned int pointCount, const Color& fillColor,
+                            float outlineThickness, const Color& outlineColor)
+{
+    if (!points)
+        return;
+
+    m_points.resize(pointCount);
+    for (unsigned int i = 0; i < pointCount; ++i)
+        m_points[i].position = points[i];
+
+    addPoints(fillColor, outlineThickness, outlineColor);
+}
+
+
+////////////////////////////////////////////////////////////
+void ShapeBatch::clear()
+{
+    m_vertices.clear();
+    m_shapeCount = 0;
+}
+
+
+////////////////////////////////////////////////////////////
+unsigned int ShapeBatch::getShapeCount() const
+{
+    return m_shapeCount;
+}
+
+
+////////////////////////////////////////////////////////////
+void ShapeBatch::draw(RenderTarget& target, RenderStates states) const
+{
+    if (m_vertices.empty())
+        return;
+
+    states.texture = NULL;
+    target.draw(&m_vertices[0], static_cast<unsigned int>(m_vertices.size()), Triangles, states);
+}
+
+
+////////////////////////////////////////////////////////////
+void ShapeBatch::addPoints(const Color& fillColor, float outlineThickness, const Color& outlineColor)
+{
+    unsigned int count = static_cast<unsigned int>(m_points.size());
+    if (count < 3)
+        return;
+
+    // The polygon is convex: its fill is a fan around its first point
+    for (unsigned int i = 1; i + 1 < count; ++i)
+    {
+        m_vertices.push_back(Vertex(m_points[0].position, fillColor));
+        m_vertices.push_back(Vertex(m_points[i].position, fillColor));
+        m_vertices.push_back(Vertex(m_points[i + 1].position, fillColor));
+    }
+
+    // The outline is computed the same way as for sf::Shape
+    if (outlineThickness != 0)
+    {
+        m_strip.resize((count + 1) * 2);
+        Shape::computeOutline(&m_points[0], count, outlineThickness, &m_strip[0]);
+
+        for (std::size_t i = 0; i < m_strip.size(); ++i)
+            m_strip[i].color = outlineColor;
+        addStrip(&m_strip[0], m_strip.size());
+    }
+
+    m_shapeCount++;
+}
+
+
+////////////////////////////////////////////////////////////
+void ShapeBatch::addStrip(const Vertex* strip, std::size_t count)
+{
+    for (std::size_t i = 0; i + 2 < count; ++i)
+    {
+        m_vertices.push_back(strip[i]);
+        m_vertices.push_back(strip[i + 1]);
+        m_vertices.push_back(strip[i + 2]);
+    }
+}
+
+} // namespace sf
@@ -0,0 +1,260 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2012 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Graphics/ShapeGeometry.hpp>
+#include <SFML/System/Mutex.hpp>
+#include <SFML/System/Lock.hpp>
+#include <cstring>
+#include <functional>
+#include <map>
+
+
+namespace
+{
+    // Geometries in use, by parameters
+    typedef std::map<sf::priv::ShapeGeometry::Key, sf::priv::ShapeGeometry*> GeometryTable;
+
+    struct Registry
+    {
+        sf::Mutex     mutex;
+        GeometryTable geometries;
+    };
+
+    // The registry is never destroyed, so that global shapes can
+    // still release their geometry when the program exits
+    Registry& getRegistry()
+    {
+        static Registry* registry = new Registry;
+        return *registry;
+    }
+
+    // Get the bits of a float, so that all the values (including NaN) are strictly ordered
+    sf::Uint32 getBits(float value)
+    {
+        sf::Uint32 bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return bits;
+    }
+
+    // Copy the positions of a vertex array
+    void copyPositions(const sf::VertexArray& vertices, std::vector<sf::Vector2f>& positions)
+    {
+        positions.resize(vertices.getVertexCount());
+        if (positions.empty())
+            return;
+
+        const sf::Vertex* vertex = &vertices[0];
+        for (std::size_t i = 0; i < positions.size(); ++i)
+            positions[i] = vertex[i].position;
+    }
+}
+
+
+namespace sf
+{
+namespace priv
+{
+////////////////////////////////////////////////////////////
+ShapeGeometry::Key::Key(const std::type_info& type, const Vector2f& parameters, unsigned int pointCount, float outlineThickness) :
+type            (&type),
+parameters      (parameters),
+pointCount      (pointCount),
+outlineThickness(outlineThickness)
+{
+}
+
+
+////////////////////////////////////////////////////////////
+bool ShapeGeometry::Key::operator <(const Key& right) const
+{
+    // Comparing the type_info objects themselves would compare the names of the classes;
+    // their addresses are enough, a class at worst doesn't share with its copy in another module
+    if (type != right.type)
+        return std::less<const std::type_info*>()(type, right.type);
+    if (pointCount != right.pointCount)
+        return pointCount < right.pointCount;
+    if (getBits(parameters.x) != getBits(right.parameters.x))
+        return getBits(parameters.x) < getBits(right.parameters.x);
+    if (getBits(parameters.y) != getBits(right.parameters.y))
+        return getBits(parameters.y) < getBits(right.parameters.y);
+    return getBits(outlineThickness) < getBits(right.outlineThickness);
+}
+
+
+////////////////////////////////////////////////////////////
+const ShapeGeometry* ShapeGeometry::find(const Key& key)
+{
+    Registry& registry = getRegistry();
+    Lock lock(registry.mutex);
+
+    GeometryTable::iterator it = registry.geometries.find(key);
+    if (it == registry.geometries.end())
+        return NULL;
+
+    it->second->m_refCount++;
+    return it->second;
+}
+
+
+////////////////////////////////////////////////////////////
+const ShapeGeometry* ShapeGeometry::insert(const Key& key, const VertexArray& vertices, const VertexArray& outlineVertices,
+                                           const FloatRect& insideBounds, const FloatRect& bounds, const ShapeGeometry* previous)
+{
+    Registry& registry = getRegistry();
+    Lock lock(registry.mutex);
+
+    // Another shape may have registered the same geometry meanwhile
+    GeometryTable::iterator it = registry.geometries.find(key);
+    if (it != registry.geometries.end())
+    {
+        it->second->m_refCount++;
+        releaseLocked(previous);
+        return it->second;
+    }
+
+    // Reuse the previous geometry if the shape was its only user
+    if (previous && (previous->m_refCount == 1))
+    {
+        ShapeGeometry* geometry = const_cast<ShapeGeometry*>(previous);
+        registry.geometries.erase(geometry->m_key);
+        geometry->assign(key, vertices, outlineVertices, insideBounds, bounds);
+        registry.geometries.insert(std::make_pair(key, geometry));
+        return geometry;
+    }
+
+    releaseLocked(previous);
+    ShapeGeometry* geometry = new ShapeGeometry(key, vertices, outlineVertices, insideBounds, bounds);
+    registry.geometries.insert(std::make_pair(key, geometry));
+
+    return geometry;
+}
+
+
+////////////////////////////////////////////////////////////
+const ShapeGeometry* ShapeGeometry::acquire(const ShapeGeometry* geometry)
+{
+    if (geometry)
+    {
+        Lock lock(getRegistry().mutex);
+        const_cast<ShapeGeometry*>(geometry)->m_refCount++;
+    }
+
+    return geometry;
+}
+
+
+////////////////////////////////////////////////////////////
+void ShapeGeometry::release(const ShapeGeometry* geometry)
+{
+    if (!geometry)
+        return;
+
+    Lock lock(getRegistry().mutex);
+    releaseLocked(geometry);
+}
+
+
+////////////////////////////////////////////////////////////
+const ShapeGeometry::Key& ShapeGeometry::getKey() const
+{
+    return m_key;
+}
+
+
+////////////////////////////////////////////////////////////
+const std::vector<Vector2f>& ShapeGeometry::getPoints() const
+{
+    return m_points;
+}
+
+
+////////////////////////////////////////////////////////////
+const std::vector<Vector2f>& ShapeGeometry::getOutline() const
+{
+    return m_outline;
+}
+
+
+////////////////////////////////////////////////////////////
+const FloatRect& ShapeGeometry::getInsideBounds() const
+{
+    return m_insideBounds;
+}
+
+
+////////////////////////////////////////////////////////////
+const FloatRect& ShapeGeometry::getBounds() const
+{
+    return m_bounds;
+}
+
+
+////////////////////////////////////////////////////////////
+ShapeGeometry::ShapeGeometry(const Key& key, const VertexArray& vertices, const VertexArray& outlineVertices,
+                             const FloatRect& insideBounds, const FloatRect& bounds) :
+m_key         (key),
+m_points      (),
+m_outline     (),
+m_insideBounds(),
+m_bounds      (),
+m_refCount    (1)
+{
+    assign(key, vertices, outlineVertices, insideBounds, bounds);
+}
+
+
+////////////////////////////////////////////////////////////
+void ShapeGeometry::assign(const Key& key, const VertexArray& vertices, const VertexArray& outlineVertices,
+                           const FloatRect& insideBounds, const FloatRect& bounds)
+{
+    m_key = key;
+
+    copyPositions(vertices, m_points);
+    copyPositions(outlineVertices, m_outline);
+
+    m_insideBounds = insideBounds;
+    m_bounds       = bounds;
+}
+
+
+////////////////////////////////////////////////////////////
+void ShapeGeometry::releaseLocked(const ShapeGeometry* geometry)
+{
+    if (!geometry)
+        return;
+
+    // Destroy the geometry if it was the last user
+    if (--const_cast<ShapeGeometry*>(geometry)->m_refCount == 0)
+    {
+        getRegistry().geometries.erase(geometry->m_key);
+        delete geometry;
+    }
+}
+
+} // namespace priv
+
+} // namespace sf
@@ -0,0 +1,242 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2012 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+#ifndef SFML_SHAPEGEOMETRY_HPP
+#define SFML_SHAPEGEOMETRY_HPP
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Graphics/VertexArray.hpp>
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/System/NonCopyable.hpp>
+#include <typeinfo>
+#include <vector>
+
+
+namespace sf
+{
+namespace priv
+{
+////////////////////////////////////////////////////////////
+/// \brief Points, outline and bounds of a shape, shared by
+///        all the shapes defined by the same parameters
+///
+/// Geometries are stored in a global registry and reference
+/// counted: the first shape that needs a geometry computes
+/// it, and the last one that releases it destroys it.
+///
+////////////////////////////////////////////////////////////
+class ShapeGeometry : NonCopyable
+{
+public :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Parameters that identify a geometry
+    ///
+    ////////////////////////////////////////////////////////////
+    struct Key
+    {
+        ////////////////////////////////////////////////////////////
+        /// \brief Construct the key from its parameters
+        ///
+        /// \param type             Class of the shape
+        /// \param parameters       Parameters that define the points of the shape
+        /// \param pointCount       Number of points of the shape
+        /// \param outlineThickness Thickness of the outline
+        ///
+        ////////////////////////////////////////////////////////////
+        Key(const std::type_info& type, const Vector2f& parameters, unsigned int pointCount, float outlineThickness);
+
+        ////////////////////////////////////////////////////////////
+        /// \brief Order keys, so that they can be used in a map
+        ///
+        /// \param right Key to compare to
+        ///
+        /// \return True if this key is ordered before \a right
+        ///
+        ////////////////////////////////////////////////////////////
+        bool operator <(const Key& right) const;
+
+        ////////////////////////////////////////////////////////////
+        // Member data
+        ////////////////////////////////////////////////////////////
+        const std::type_info* type;             ///< Class of the shape
+        Vector2f              parameters;       ///< Parameters that define the points of the shape
+        unsigned int          pointCount;       ///< Number of points of the shape
+        float                 outlineThickness; ///< Thickness of the outline
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the geometry of a key, if a shape already uses it
+    ///
+    /// The geometry must be given back with release() when it
+    /// is no longer used.
+    ///
+    /// \param key Parameters of the geometry
+    ///
+    /// \return Shared geometry, or NULL if no shape uses it
+    ///
+    ////////////////////////////////////////////////////////////
+    static const ShapeGeometry* find(const Key& key);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Share the geometry that a shape has just computed
+    ///
+    /// If another shape has registered the same key meanwhile,
+    /// its geometry is returned instead. The geometry must be
+    /// given back with release() when it is no longer used.
+    ///
+    /// The shape gives back its previous geometry at the same
+    /// time: if no other shape uses it, it is reused for the
+    /// new one instead of being destroyed, so that a shape
+    /// whose parameters keep changing doesn't allocate a new
+    /// geometry every time.
+    ///
+    /// \param key             Parameters of the geometry
+    /// \param vertices        Fill vertices of the shape
+    /// \param outlineVertices Outline vertices of the shape
+    /// \param insideBounds    Bounding rectangle of the inside (fill)
+    /// \param bounds          Bounding rectangle of the whole shape
+    /// \param previous        Geometry that the shape releases (can be NULL)
+    ///
+    /// \return Shared geometry
+    ///
+    ////////////////////////////////////////////////////////////
+    static const ShapeGeometry* insert(const Key& key, const VertexArray& vertices, const VertexArray& outlineVertices,
+                                       const FloatRect& insideBounds, const FloatRect& bounds, const ShapeGeometry* previous);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Share a geometry that is already in use
+    ///
+    /// \param geometry Geometry to share (can be NULL)
+    ///
+    /// \return \a geometry
+    ///
+    ////////////////////////////////////////////////////////////
+    static const ShapeGeometry* acquire(const ShapeGeometry* geometry);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Stop using a geometry
+    ///
+    /// The geometry is destroyed if no other shape uses it.
+    ///
+    /// \param geometry Geometry to release (can be NULL)
+    ///
+    ////////////////////////////////////////////////////////////
+    static void release(const ShapeGeometry* geometry);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the parameters of the geometry
+    ///
+    /// \return Key of the geometry
+    ///
+    ////////////////////////////////////////////////////////////
+    const Key& getKey() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the positions of the fill vertices
+    ///
+    /// \return Positions of the center, the points, and the first point repeated
+    ///
+    ////////////////////////////////////////////////////////////
+    const std::vector<Vector2f>& getPoints() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the positions of the outline vertices
+    ///
+    /// \return Positions of the outline triangle strip
+    ///
+    ////////////////////////////////////////////////////////////
+    const std::vector<Vector2f>& getOutline() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the bounding rectangle of the inside (fill)
+    ///
+    /// \return Bounding rectangle of the fill
+    ///
+    ////////////////////////////////////////////////////////////
+    const FloatRect& getInsideBounds() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the bounding rectangle of the whole shape
+    ///
+    /// \return Bounding rectangle of the outline and fill
+    ///
+    ////////////////////////////////////////////////////////////
+    const FloatRect& getBounds() const;
+
+private :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Copy the geometry of a shape
+    ///
+    /// \param key             Parameters of the geometry
+    /// \param vertices        Fill vertices of the shape
+    /// \param outlineVertices Outline vertices of the shape
+    /// \param insideBounds    Bounding rectangle of the inside (fill)
+    /// \param bounds          Bounding rectangle of the whole shape
+    ///
+    ////////////////////////////////////////////////////////////
+    ShapeGeometry(const Key& key, const VertexArray& vertices, const VertexArray& outlineVertices,
+                  const FloatRect& insideBounds, const FloatRect& bounds);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Replace the contents of the geometry with the ones of a shape
+    ///
+    /// \param key             Parameters of the geometry
+    /// \param vertices        Fill vertices of the shape
+    /// \param outlineVertices Outline vertices of the shape
+    /// \param insideBounds    Bounding rectangle of the inside (fill)
+    /// \param bounds          Bounding rectangle of the whole shape
+    ///
+    ////////////////////////////////////////////////////////////
+    void assign(const Key& key, const VertexArray& vertices, const VertexArray& outlineVertices,
+                const FloatRect& insideBounds, const FloatRect& bounds);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Stop using a geometry, the registry being already locked
+    ///
+    /// \param geometry Geometry to release (can be NULL)
+    ///
+    ////////////////////////////////////////////////////////////
+    static void releaseLocked(const ShapeGeometry* geometry);
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    Key                   m_key;          ///< Parameters of the geometry, which identify it in the registry
+    std::vector<Vector2f> m_points;       ///< Positions of the fill vertices
+    std::vector<Vector2f> m_outline;      ///< Positions of the outline vertices
+    FloatRect             m_insideBounds; ///< Bounding rectangle of the inside (fill)
+    FloatRect             m_bounds;       ///< Bounding rectangle of the whole shape (outline + fill)
+    unsigned int          m_refCount;     ///< Number of shapes that use the geometry
+};
+
+} // namespace priv
+
+} // namespace sf
+
+
+#endif // SFML_SHAPEGEOMETRY_HPP
@@ -0,0 +1,211 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2012 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Graphics/SkylinePacker.hpp>
+#include <algorithm>
+
+
+namespace sf
+{
+namespace priv
+{
+////////////////////////////////////////////////////////////
+SkylinePacker::SkylinePacker() :
+m_width   (0),
+m_height  (0),
+m_usedArea(0),
+m_skyline ()
+{
+}
+
+
+////////////////////////////////////////////////////////////
+SkylinePacker::SkylinePacker(unsigned int width, unsigned int height) :
+m_width   (0),
+m_height  (0),
+m_usedArea(0),
+m_skyline ()
+{
+    clear(width, height);
+}
+
+
+////////////////////////////////////////////////////////////
+void SkylinePacker::clear(unsigned int width, unsigned int height)
+{
+    m_width = width;
+    m_height = height;
+    m_usedArea = 0;
+
+    // The skyline starts as a single segment at the bottom of the area
+    Segment segment = {0, 0, width};
+    m_skyline.assign(1, segment);
+}
+
+
+////////////////////////////////////////////////////////////
+void SkylinePacker::resize(unsigned int width, unsigned int height)
+{
+    // The new space on the right is empty: add a segment at the bottom for it
+    if (width > m_width)
+    {
+        Segment segment = {m_width, 0, width - m_width};
+        if (!m_skyline.empty() && (m_skyline.back().y == 0))
+            m_skyline.back().width += segment.width;
+        else
+            m_skyline.push_back(segment);
+
+        m_width = width;
+    }
+
+    // The new space on the bottom doesn't change the skyline
+    m_height = std::max(height, m_height);
+}
+
+
+////////////////////////////////////////////////////////////
+bool SkylinePacker::insert(unsigned int width, unsigned int height, Vector2u& position)
+{
+    if ((width == 0) || (height == 0))
+        return false;
+
+    // Find the segment where the top of the rectangle is the lowest;
+    // in case of equality, choose the narrowest segment to waste less space
+    std::size_t bestIndex = m_skyline.size();
+    unsigned int bestTop = 0;
+    unsigned int bestWidth = 0;
+    unsigned int bestY = 0;
+    for (std::size_t i = 0; i < m_skyline.size(); ++i)
+    {
+        unsigned int y;
+        if (fits(i, width, height, y))
+        {
+            unsigned int top = y + height;
+            if ((bestIndex == m_skyline.size()) || (top < bestTop) || ((top == bestTop) && (m_skyline[i].width < bestWidth)))
+            {
+                bestIndex = i;
+                bestTop = top;
+                bestWidth = m_skyline[i].width;
+                bestY = y;
+            }
+        }
+    }
+
+    if (bestIndex == m_skyline.size())
+        return false;
+
+    position.x = m_skyline[bestIndex].x;
+    position.y = bestY;
+
+    // Insert the new segment on top of the rectangle
+    Segment segment = {position.x, bestY + height, width};
+    m_skyline.insert(m_skyline.begin() + bestIndex, segment);
+
+    // Shrink or remove the segments that are now below it
+    for (std::size_t i = bestIndex + 1; i < m_skyline.size(); )
+    {
+        unsigned int previousRight = m_skyline[i - 1].x + m_skyline[i - 1].width;
+        if (m_skyline[i].x >= previousRight)
+            break;
+
+        unsigned int shrink = previousRight - m_skyline[i].x;
+        if (m_skyline[i].width <= shrink)
+        {
+            m_skyline.erase(m_skyline.begin() + i);
+        }
+        else
+        {
+            m_skyline[i].x += shrink;
+            m_skyline[i].width -= shrink;
+            break;
+        }
+    }
+
+    // Merge the neighbour segments that are at the same height
+    for (std::size_t i = 1; i < m_skyline.size(); )
+    {
+        if (m_skyline[i - 1].y == m_skyline[i].y)
+        {
+            m_skyline[i - 1].width += m_skyline[i].width;
+            m_skyline.erase(m_skyline.begin() + i);
+        }
+        else
+        {
+            ++i;
+        }
+    }
+
+    m_usedArea += width * height;
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+unsigned int SkylinePacker::getUsedArea() const
+{
+    return m_usedArea;
+}
+
+
+////////////////////////////////////////////////////////////
+Vector2u SkylinePacker::getSize() const
+{
+    return Vector2u(m_width, m_height);
+}
+
+
+////////////////////////////////////////////////////////////
+bool SkylinePacker::fits(std::size_t index, unsigned int width, unsigned int height, unsigned int& y) const
+{
+    if (m_skyline[index].x + width > m_width)
+        return false;
+
+    // The rectangle rests on the highest segment that it covers
+    y = 0;
+    unsigned int remaining = width;
+    for (std::size_t i = index; remaining > 0; ++i)
+    {
+        if (i == m_skyline.size())
+            return false;
+
+        y = std::max(y, m_skyline[i].y);
+        if (y + height > m_height)
+            return false;
+
+        if (m_skyline[i].width >= remaining)
+            break;
+
+        remaining -= m_skyline[i].width;
+    }
+
+    return true;
+}
+
+} // namespace priv
+
+} // namespace sf
@@ -0,0 +1,157 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2012 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+#ifndef SFML_SKYLINEPACKER_HPP
+#define SFML_SKYLINEPACKER_HPP
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/System/Vector2.hpp>
+#include <vector>
+
+
+namespace sf
+{
+namespace priv
+{
+////////////////////////////////////////////////////////////
+/// \brief Packs rectangles into a bigger rectangle, using
+///        the skyline bottom-left algorithm
+///
+/// The packer keeps track of the top edge ("skyline") of the
+/// rectangles packed so far, and places each new rectangle
+/// where its top is the lowest. Packed rectangles can't be
+/// removed individually: the packer must be cleared and the
+/// rectangles inserted again.
+///
+////////////////////////////////////////////////////////////
+class SkylinePacker
+{
+public :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Default constructor
+    ///
+    /// Creates an empty packer of size 0x0.
+    ///
+    ////////////////////////////////////////////////////////////
+    SkylinePacker();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Construct an empty packer with a given size
+    ///
+    /// \param width  Width of the packing area
+    /// \param height Height of the packing area
+    ///
+    ////////////////////////////////////////////////////////////
+    SkylinePacker(unsigned int width, unsigned int height);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Remove all the packed rectangles
+    ///
+    /// \param width  New width of the packing area
+    /// \param height New height of the packing area
+    ///
+    ////////////////////////////////////////////////////////////
+    void clear(unsigned int width, unsigned int height);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Enlarge the packing area, keeping the packed rectangles
+    ///
+    /// \param width  New width of the packing area (must not be smaller than the current one)
+    /// \param height New height of the packing area (must not be smaller than the current one)
+    ///
+    ////////////////////////////////////////////////////////////
+    void resize(unsigned int width, unsigned int height);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Find a free place for a new rectangle
+    ///
+    /// \param width    Width of the rectangle
+    /// \param height   Height of the rectangle
+    /// \param position Receives the top-left corner of the rectangle, if it fits
+    ///
+    /// \return True if the rectangle fits, false if there's not enough space
+    ///
+    ////////////////////////////////////////////////////////////
+    bool insert(unsigned int width, unsigned int height, Vector2u& position);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the total area of the packed rectangles
+    ///
+    /// \return Area covered by the rectangles, in pixels
+    ///
+    ////////////////////////////////////////////////////////////
+    unsigned int getUsedArea() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the size of the packing area
+    ///
+    /// \return Size of the packing area
+    ///
+    ////////////////////////////////////////////////////////////
+    Vector2u getSize() const;
+
+private :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Horizontal segment of the skyline
+    ///
+    ////////////////////////////////////////////////////////////
+    struct Segment
+    {
+        unsigned int x;     ///< Left of the segment
+        unsigned int y;     ///< Height of the skyline along the segment
+        unsigned int width; ///< Width of the segment
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Check if a rectangle fits with its left side on a given segment
+    ///
+    /// \param index  Index of the segment
+    /// \param width  Width of the rectangle
+    /// \param height Height of the rectangle
+    /// \param y      Receives the top of the rectangle, if it fits
+    ///
+    /// \return True if the rectangle fits
+    ///
+    ////////////////////////////////////////////////////////////
+    bool fits(std::size_t index, unsigned int width, unsigned int height, unsigned int& y) const;
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    unsigned int         m_width;    ///< Width of the packing area
+    unsigned int         m_height;   ///< Height of the packing area
+    unsigned int         m_usedArea; ///< Total area of the packed rectangles
+    std::vector<Segment> m_skyline;  ///< Segments of the skyline, from left to right
+};
+
+} // namespace priv
+
+} // namespace sf
+
+
+#endif // SFML_SKYLINEPACKER_HPP
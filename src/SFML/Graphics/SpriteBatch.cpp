@@ -0,0 +1,257 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2012 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Graphics/SpriteBatch.hpp>
+#include <SFML/Graphics/Sprite.hpp>
+#include <SFML/Graphics/Transformable.hpp>
+#include <SFML/Graphics/Texture.hpp>
+#include <SFML/Graphics/RenderTarget.hpp>
+#include <algorithm>
+#include <functional>
+#include <cstdlib>
+#include <cmath>
+
+
+namespace
+{
+    // Compare two sprites by texture
+    struct TextureLess
+    {
+        TextureLess(const std::vector<const sf::Texture*>& textures) : textures(textures) {}
+
+        bool operator ()(unsigned int left, unsigned int right) const
+        {
+            return std::less<const sf::Texture*>()(textures[left], textures[right]);
+        }
+
+        const std::vector<const sf::Texture*>& textures;
+    };
+
+    // Compare two sprites by decreasing depth
+    struct DepthGreater
+    {
+        DepthGreater(const std::vector<float>& depths) : depths(depths) {}
+
+        bool operator ()(unsigned int left, unsigned int right) const
+        {
+            return depths[left] > depths[right];
+        }
+
+        const std::vector<float>& depths;
+    };
+}
+
+
+namespace sf
+{
+////////////////////////////////////////////////////////////
+SpriteBatch::SpriteBatch() :
+m_sortMode    (Submission),
+m_positions   (),
+m_origins     (),
+m_scales      (),
+m_rotations   (),
+m_textureRects(),
+m_colors      (),
+m_textures    (),
+m_depths      (),
+m_order       (),
+m_vertices    (),
+m_needUpdate  (false)
+{
+}
+
+
+////////////////////////////////////////////////////////////
+SpriteBatch::SpriteBatch(SortMode sortMode) :
+m_sortMode    (sortMode),
+m_positions   (),
+m_origins     (),
+m_scales      (),
+m_rotations   (),
+m_textureRects(),
+m_colors      (),
+m_textures    (),
+m_depths      (),
+m_order       (),
+m_vertices    (),
+m_needUpdate  (false)
+{
+}
+
+
+////////////////////////////////////////////////////////////
+void SpriteBatch::add(const Texture& texture, const IntRect& textureRect, const Transformable& transformable,
+                      const Color& color, float depth)
+{
+    m_positions.push_back(transformable.getPosition());
+    m_origins.push_back(transformable.getOrigin());
+    m_scales.push_back(transformable.getScale());
+    m_rotations.push_back(transformable.getRotation());
+    m_textureRects.push_back(textureRect);
+    m_colors.push_back(color);
+    m_textures.push_back(&texture);
+    m_depths.push_back(depth);
+
+    m_needUpdate = true;
+}
+
+
+////////////////////////////////////////////////////////////
+void SpriteBatch::add(const Sprite& sprite, float depth)
+{
+    if (sprite.getTexture())
+        add(*sprite.getTexture(), sprite.getTextureRect(), sprite, sprite.getColor(), depth);
+}
+
+
+////////////////////////////////////////////////////////////
+void SpriteBatch::clear()
+{
+    m_positions.clear();
+    m_origins.clear();
+    m_scales.clear();
+    m_rotations.clear();
+    m_textureRects.clear();
+    m_colors.clear();
+    m_textures.clear();
+    m_depths.clear();
+
+    m_needUpdate = true;
+}
+
+
+////////////////////////////////////////////////////////////
+unsigned int SpriteBatch::getSpriteCount() const
+{
+    return static_cast<unsigned int>(m_textures.size());
+}
+
+
+////////////////////////////////////////////////////////////
+void SpriteBatch::setSortMode(SortMode sortMode)
+{
+    if (sortMode != m_sortMode)
+    {
+        m_sortMode = sortMode;
+        m_needUpdate = true;
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+SpriteBatch::SortMode SpriteBatch::getSortMode() const
+{
+    return m_sortMode;
+}
+
+
+////////////////////////////////////////////////////////////
+void SpriteBatch::draw(RenderTarget& target, RenderStates states) const
+{
+    if (m_needUpdate)
+        update();
+
+    // Draw the sprites, with one call per sequence of sprites sharing the same texture
+    std::size_t count = m_order.size();
+    std::size_t first = 0;
+    for (std::size_t i = 1; i <= count; ++i)
+    {
+        if ((i == count) || (m_textures[m_order[i]] != m_textures[m_order[first]]))
+        {
+            states.texture = m_textures[m_order[first]];
+            target.draw(&m_vertices[first * 4], static_cast<unsigned int>((i - first) * 4), Quads, states);
+            first = i;
+        }
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void SpriteBatch::update() const
+{
+    std::size_t count = m_textures.size();
+
+    // Sort the sprites; the sort is stable so that sprites which compare
+    // equal are still drawn in submission order
+    m_order.resize(count);
+    for (std::size_t i = 0; i < count; ++i)
+        m_order[i] = static_cast<unsigned int>(i);
+
+    switch (m_sortMode)
+    {
+        case ByTexture :   std::stable_sort(m_order.begin(), m_order.end(), TextureLess(m_textures)); break;
+        case BackToFront : std::stable_sort(m_order.begin(), m_order.end(), DepthGreater(m_depths));   break;
+        default :          break;
+    }
+
+    // Generate the quads
+    m_vertices.resize(count * 4);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        unsigned int index = m_order[i];
+        const IntRect& rect = m_textureRects[index];
+
+        // Compute the transform, the same way as sf::Transformable does
+        float angle  = -m_rotations[index] * 3.141592654f / 180.f;
+        float cosine = static_cast<float>(std::cos(angle));
+        float sine   = static_cast<float>(std::sin(angle));
+        float sxc    = m_scales[index].x * cosine;
+        float syc    = m_scales[index].y * cosine;
+        float sxs    = m_scales[index].x * sine;
+        float sys    = m_scales[index].y * sine;
+        float tx     = -m_origins[index].x * sxc - m_origins[index].y * sys + m_positions[index].x;
+        float ty     =  m_origins[index].x * sxs - m_origins[index].y * syc + m_positions[index].y;
+
+        // Corners of the sprite, in the same order as sf::Sprite
+        float width  = static_cast<float>(std::abs(rect.width));
+        float height = static_cast<float>(std::abs(rect.height));
+        Vertex* quad = &m_vertices[i * 4];
+        quad[0].position = Vector2f(tx, ty);
+        quad[1].position = Vector2f(sys * height + tx, syc * height + ty);
+        quad[2].position = Vector2f(sxc * width + sys * height + tx, -sxs * width + syc * height + ty);
+        quad[3].position = Vector2f(sxc * width + tx, -sxs * width + ty);
+
+        float left   = static_cast<float>(rect.left);
+        float right  = left + rect.width;
+        float top    = static_cast<float>(rect.top);
+        float bottom = top + rect.height;
+        quad[0].texCoords = Vector2f(left, top);
+        quad[1].texCoords = Vector2f(left, bottom);
+        quad[2].texCoords = Vector2f(right, bottom);
+        quad[3].texCoords = Vector2f(right, top);
+
+        quad[0].color = m_colors[index];
+        quad[1].color = m_colors[index];
+        quad[2].color = m_colors[index];
+        quad[3].color = m_colors[index];
+    }
+
+    m_needUpdate = false;
+}
+
+} // namespace sf
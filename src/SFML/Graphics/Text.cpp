@@ -28,9 +28,34 @@
 #include <SFML/Graphics/Text.hpp>
 #include <SFML/Graphics/Texture.hpp>
 #include <SFML/Graphics/RenderTarget.hpp>
+#include <algorithm>
 #include <cassert>
 
 
+namespace
+{
+    // Extend a rectangle so that it contains a range of vertices
+    sf::FloatRect extendBounds(const sf::FloatRect& bounds, const sf::VertexArray& vertices, unsigned int first)
+    {
+        float left   = bounds.left;
+        float top    = bounds.top;
+        float right  = bounds.left + bounds.width;
+        float bottom = bounds.top + bounds.height;
+
+        for (unsigned int i = first; i < vertices.getVertexCount(); ++i)
+        {
+            sf::Vector2f position = vertices[i].position;
+            left   = std::min(left, position.x);
+            top    = std::min(top, position.y);
+            right  = std::max(right, position.x);
+            bottom = std::max(bottom, position.y);
+        }
+
+        return sf::FloatRect(left, top, right - left, bottom - top);
+    }
+}
+
+
 namespace sf
 {
 ////////////////////////////////////////////////////////////
@@ -41,7 +66,10 @@ m_characterSize(30),
 m_style        (Regular),
 m_color        (255, 255, 255),
 m_vertices     (Quads),
-m_bounds       ()
+m_bounds       (),
+m_glyphBounds  (),
+m_layout       (),
+m_revision     (0)
 {
 
 }
@@ -55,7 +83,10 @@ m_characterSize(characterSize),
 m_style        (Regular),
 m_color        (255, 255, 255),
 m_vertices     (Quads),
-m_bounds       ()
+m_bounds       (),
+m_glyphBounds  (),
+m_layout       (),
+m_revision     (0)
 {
     updateGeometry();
 }
@@ -64,8 +95,16 @@ m_bounds       ()
 ////////////////////////////////////////////////////////////
 void Text::setString(const String& string)
 {
+    // If the new string only adds characters at the end, the current geometry remains valid
+    std::size_t size = m_string.getSize();
+    bool append = m_font && (size > 0) && (string.getSize() > size) && std::equal(m_string.begin(), m_string.end(), string.begin());
+
     m_string = string;
-    updateGeometry();
+
+    if (append)
+        appendGeometry(size);
+    else
+        updateGeometry();
 }
 
 
@@ -110,6 +149,7 @@ void Text::setColor(const Color& color)
         m_color = color;
         for (unsigned int i = 0; i < m_vertices.getVertexCount(); ++i)
             m_vertices[i].color = m_color;
+        ++m_revision;
     }
 }
 
@@ -156,38 +196,8 @@ Vector2f Text::findCharacterPos(std::size_t index) const
     if (!m_font)
         return Vector2f();
 
-    // Adjust the index if it's out of range
-    if (index > m_string.getSize())
-        index = m_string.getSize();
-
-    // Precompute the variables needed by the algorithm
-    bool  bold   = (m_style & Bold) != 0;
-    float hspace = static_cast<float>(m_font->getGlyph(L' ', m_characterSize, bold).advance);
-    float vspace = static_cast<float>(m_font->getLineSpacing(m_characterSize));
-
-    // Compute the position
-    Vector2f position;
-    Uint32 prevChar = 0;
-    for (std::size_t i = 0; i < index; ++i)
-    {
-        Uint32 curChar = m_string[i];
-
-        // Apply the kerning offset
-        position.x += static_cast<float>(m_font->getKerning(prevChar, curChar, m_characterSize));
-        prevChar = curChar;
-
-        // Handle special characters
-        switch (curChar)
-        {
-            case L' ' :  position.x += hspace;                 continue;
-            case L'\t' : position.x += hspace * 4;             continue;
-            case L'\n' : position.y += vspace; position.x = 0; continue;
-            case L'\v' : position.y += vspace * 4;             continue;
-        }
-
-        // For regular characters, add the advance offset of the glyph
-        position.x += static_cast<float>(m_font->getGlyph(curChar, m_characterSize, bold).advance);
-    }
+    // The positions of the characters are known since the last layout
+    Vector2f position = m_layout.getCharacterPosition(std::min(index, m_string.getSize()));
 
     // Transform the position to global coordinates
     position = getTransform().transformPoint(position);
@@ -217,6 +227,11 @@ void Text::draw(RenderTarget& target, RenderStates states) const
     {
         states.transform *= getTransform();
         states.texture = &m_font->getTexture(m_characterSize);
+
+        // Distance field glyphs need the shader of the font, unless the user provides one
+        if (!states.shader)
+            states.shader = m_font->getShader();
+
         target.draw(m_vertices, states);
     }
 }
@@ -227,7 +242,10 @@ void Text::updateGeometry()
 {
     // Clear the previous geometry
     m_vertices.clear();
+    m_layout.clear();
+    ++m_revision;
     m_bounds = FloatRect();
+    m_glyphBounds = FloatRect();
 
     // No font: nothing to draw
     if (!m_font)
@@ -237,28 +255,39 @@ void Text::updateGeometry()
     if (m_string.isEmpty())
         return;
 
+    // Lay out the whole string
+    m_layout.reset(*m_font, m_characterSize, (m_style & Bold) != 0);
+    appendGeometry(0);
+}
+
+
+////////////////////////////////////////////////////////////
+void Text::appendGeometry(std::size_t first)
+{
     // Compute values related to the text style
     bool  bold               = (m_style & Bold) != 0;
     bool  underlined         = (m_style & Underlined) != 0;
     float italic             = (m_style & Italic) ? 0.208f : 0.f; // 12 degrees
     float underlineOffset    = m_characterSize * 0.1f;
     float underlineThickness = m_characterSize * (bold ? 0.1f : 0.07f);
+    float baseline           = static_cast<float>(m_characterSize);
+
+    // The underline of the last line is extended by the new characters: remove it, it's added again at the end
+    if (underlined && (m_vertices.getVertexCount() >= 4))
+        m_vertices.resize(m_vertices.getVertexCount() - 4);
+    unsigned int firstVertex = m_vertices.getVertexCount();
+    ++m_revision;
 
-    // Precompute the variables needed by the algorithm
-    float hspace = static_cast<float>(m_font->getGlyph(L' ', m_characterSize, bold).advance);
-    float vspace = static_cast<float>(m_font->getLineSpacing(m_characterSize));
-    float x      = 0.f;
-    float y      = static_cast<float>(m_characterSize);
+    // Compute the position of the new characters
+    m_layout.append(m_string);
 
     // Create one quad for each character
-    Uint32 prevChar = 0;
-    for (std::size_t i = 0; i < m_string.getSize(); ++i)
+    for (std::size_t i = first; i < m_string.getSize(); ++i)
     {
         Uint32 curChar = m_string[i];
-
-        // Apply the kerning offset
-        x += static_cast<float>(m_font->getKerning(prevChar, curChar, m_characterSize));
-        prevChar = curChar;
+        Vector2f position = m_layout.getCharacterPosition(i);
+        float x = position.x;
+        float y = position.y + baseline;
 
         // If we're using the underlined style and there's a new line, draw a line
         if (underlined && (curChar == L'\n'))
@@ -272,14 +301,9 @@ void Text::updateGeometry()
             m_vertices.append(Vertex(Vector2f(0, bottom), m_color, Vector2f(1, 1)));
         }
 
-        // Handle special characters
-        switch (curChar)
-        {
-            case L' ' :  x += hspace;        continue;
-            case L'\t' : x += hspace * 4;    continue;
-            case L'\n' : y += vspace; x = 0; continue;
-            case L'\v' : y += vspace * 4;    continue;
-        }
+        // Whitespaces have no geometry
+        if ((curChar == L' ') || (curChar == L'\t') || (curChar == L'\n') || (curChar == L'\v'))
+            continue;
 
         // Extract the current glyph's description
         const Glyph& glyph = m_font->getGlyph(curChar, m_characterSize, bold);
@@ -299,25 +323,30 @@ void Text::updateGeometry()
         m_vertices.append(Vertex(Vector2f(x + right - italic * top,    y + top),    m_color, Vector2f(u2, v1)));
         m_vertices.append(Vertex(Vector2f(x + right - italic * bottom, y + bottom), m_color, Vector2f(u2, v2)));
         m_vertices.append(Vertex(Vector2f(x + left  - italic * bottom, y + bottom), m_color, Vector2f(u1, v2)));
-
-        // Advance to the next character
-        x += glyph.advance;
     }
 
+    // Extend the bounding rectangle with the new quads only
+    if (firstVertex == 0)
+        m_glyphBounds = m_vertices.getBounds();
+    else
+        m_glyphBounds = extendBounds(m_glyphBounds, m_vertices, firstVertex);
+    m_bounds = m_glyphBounds;
+
     // If we're using the underlined style, add the last line
     if (underlined)
     {
-        float top = y + underlineOffset;
+        Vector2f pen = m_layout.getCharacterPosition(m_string.getSize());
+        float top = pen.y + baseline + underlineOffset;
         float bottom = top + underlineThickness;
 
-        m_vertices.append(Vertex(Vector2f(0, top),    m_color, Vector2f(1, 1)));
-        m_vertices.append(Vertex(Vector2f(x, top),    m_color, Vector2f(1, 1)));
-        m_vertices.append(Vertex(Vector2f(x, bottom), m_color, Vector2f(1, 1)));
-        m_vertices.append(Vertex(Vector2f(0, bottom), m_color, Vector2f(1, 1)));
-    }
+        unsigned int underline = m_vertices.getVertexCount();
+        m_vertices.append(Vertex(Vector2f(0,     top),    m_color, Vector2f(1, 1)));
+        m_vertices.append(Vertex(Vector2f(pen.x, top),    m_color, Vector2f(1, 1)));
+        m_vertices.append(Vertex(Vector2f(pen.x, bottom), m_color, Vector2f(1, 1)));
+        m_vertices.append(Vertex(Vector2f(0,     bottom), m_color, Vector2f(1, 1)));
 
-    // Recompute the bounding rectangle
-    m_bounds = m_vertices.getBounds();
+        m_bounds = (underline == 0) ? m_vertices.getBounds() : extendBounds(m_glyphBounds, m_vertices, underline);
+    }
 }
 
 } // namespace sf
@@ -0,0 +1,271 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2012 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Graphics/TextBatch.hpp>
+#include <SFML/Graphics/Text.hpp>
+#include <SFML/Graphics/Font.hpp>
+#include <SFML/Graphics/VertexBuffer.hpp>
+#include <SFML/Graphics/RenderTarget.hpp>
+#include <algorithm>
+
+
+namespace
+{
+    // Index of the group of the texts that have no font
+    const std::size_t noGroup = static_cast<std::size_t>(-1);
+
+    // Compare two transforms
+    bool equal(const sf::Transform& left, const sf::Transform& right)
+    {
+        return std::equal(left.getMatrix(), left.getMatrix() + 16, right.getMatrix());
+    }
+}
+
+
+namespace sf
+{
+////////////////////////////////////////////////////////////
+TextBatch::TextBatch() :
+m_entries(),
+m_groups ()
+{
+}
+
+
+////////////////////////////////////////////////////////////
+TextBatch::~TextBatch()
+{
+    clear();
+}
+
+
+////////////////////////////////////////////////////////////
+void TextBatch::add(const Text& text)
+{
+    for (std::vector<Entry>::const_iterator it = m_entries.begin(); it != m_entries.end(); ++it)
+    {
+        if (it->text == &text)
+            return;
+    }
+
+    // The text is copied to its group at the next update
+    Entry entry;
+    entry.text        = &text;
+    entry.group       = noGroup;
+    entry.offset      = 0;
+    entry.vertexCount = 0;
+    entry.revision    = 0;
+    m_entries.push_back(entry);
+}
+
+
+////////////////////////////////////////////////////////////
+void TextBatch::remove(const Text& text)
+{
+    for (std::vector<Entry>::iterator it = m_entries.begin(); it != m_entries.end(); ++it)
+    {
+        if (it->text == &text)
+        {
+            if (it->group != noGroup)
+                m_groups[it->group].needRebuild = true;
+
+            m_entries.erase(it);
+            return;
+        }
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void TextBatch::clear()
+{
+    for (std::vector<Group>::iterator it = m_groups.begin(); it != m_groups.end(); ++it)
+        delete it->buffer;
+
+    m_groups.clear();
+    m_entries.clear();
+}
+
+
+////////////////////////////////////////////////////////////
+unsigned int TextBatch::getTextCount() const
+{
+    return static_cast<unsigned int>(m_entries.size());
+}
+
+
+////////////////////////////////////////////////////////////
+void TextBatch::draw(RenderTarget& target, RenderStates states) const
+{
+    update();
+
+    // Draw each group with a single call
+    const Shader* shader = states.shader;
+    for (std::vector<Group>::const_iterator it = m_groups.begin(); it != m_groups.end(); ++it)
+    {
+        if (it->vertices.empty())
+            continue;
+
+        states.texture = &it->font->getTexture(it->characterSize);
+
+        // Distance field glyphs need the shader of the font, unless the user provides one
+        states.shader = shader ? shader : it->font->getShader();
+
+        unsigned int vertexCount = static_cast<unsigned int>(it->vertices.size());
+        if (it->buffer)
+            target.draw(*it->buffer, 0, vertexCount, states);
+        else
+            target.draw(&it->vertices[0], vertexCount, Quads, states);
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void TextBatch::update() const
+{
+    // Copy the texts that have changed since the last update
+    for (std::vector<Entry>::iterator it = m_entries.begin(); it != m_entries.end(); ++it)
+    {
+        const Text& text = *it->text;
+        std::size_t group = text.m_font ? getGroup(text.m_font, text.m_characterSize) : noGroup;
+        std::size_t vertexCount = text.m_font ? text.m_vertices.getVertexCount() : 0;
+
+        if ((group != it->group) || (vertexCount != it->vertexCount))
+        {
+            // The text moves to another group, or its range is resized: both groups must be regenerated
+            if (it->group != noGroup)
+                m_groups[it->group].needRebuild = true;
+            if (group != noGroup)
+                m_groups[group].needRebuild = true;
+
+            it->group = group;
+        }
+        else if ((group != noGroup) && !m_groups[group].needRebuild &&
+                 ((text.m_revision != it->revision) || !equal(text.getTransform(), it->transform)))
+        {
+            // Same number of vertices: overwrite the range of the text
+            Group& target = m_groups[group];
+            if (vertexCount > 0)
+                text.getTransform().transformPoints(&text.m_vertices[0], &target.vertices[it->offset], vertexCount);
+
+            target.dirtyBegin = std::min(target.dirtyBegin, it->offset);
+            target.dirtyEnd   = std::max(target.dirtyEnd, it->offset + vertexCount);
+        }
+
+        it->revision = text.m_revision;
+        it->transform = text.getTransform();
+    }
+
+    // Regenerate the groups whose texts were added, removed or resized, and upload the modified vertices
+    for (std::size_t i = 0; i < m_groups.size(); ++i)
+    {
+        Group& group = m_groups[i];
+
+        if (group.needRebuild)
+            rebuildGroup(i);
+
+        if ((group.dirtyBegin < group.dirtyEnd) && !group.vertices.empty())
+        {
+            // Create the vertex buffer the first time the group has vertices
+            if (!group.buffer && VertexBuffer::isAvailable())
+            {
+                group.buffer = new VertexBuffer(Quads, VertexBuffer::Dynamic);
+                if (!group.buffer->create(static_cast<unsigned int>(group.vertices.size())))
+                {
+                    delete group.buffer;
+                    group.buffer = NULL;
+                }
+            }
+
+            // A range of the buffer is replaced, or the whole buffer if the group was resized
+            if (group.buffer)
+            {
+                unsigned int first = static_cast<unsigned int>(group.dirtyBegin);
+                unsigned int count = static_cast<unsigned int>(group.dirtyEnd - group.dirtyBegin);
+                group.buffer->update(&group.vertices[first], count, first);
+            }
+        }
+
+        group.dirtyBegin = group.vertices.size();
+        group.dirtyEnd   = 0;
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+std::size_t TextBatch::getGroup(const Font* font, unsigned int characterSize) const
+{
+    for (std::size_t i = 0; i < m_groups.size(); ++i)
+    {
+        if ((m_groups[i].font == font) && (m_groups[i].characterSize == characterSize))
+            return i;
+    }
+
+    Group group;
+    group.font          = font;
+    group.characterSize = characterSize;
+    group.buffer        = NULL;
+    group.needRebuild   = true;
+    group.dirtyBegin    = 0;
+    group.dirtyEnd      = 0;
+    m_groups.push_back(group);
+
+    return m_groups.size() - 1;
+}
+
+
+////////////////////////////////////////////////////////////
+void TextBatch::rebuildGroup(std::size_t group) const
+{
+    Group& target = m_groups[group];
+
+    // Pack the texts of the group in submission order
+    std::size_t offset = 0;
+    for (std::vector<Entry>::iterator it = m_entries.begin(); it != m_entries.end(); ++it)
+    {
+        if (it->group != group)
+            continue;
+
+        const Text& text = *it->text;
+        it->offset      = offset;
+        it->vertexCount = text.m_vertices.getVertexCount();
+
+        target.vertices.resize(offset + it->vertexCount);
+        if (it->vertexCount > 0)
+            text.getTransform().transformPoints(&text.m_vertices[0], &target.vertices[offset], it->vertexCount);
+
+        offset += it->vertexCount;
+    }
+    target.vertices.resize(offset);
+
+    // The whole group must be uploaded again
+    target.needRebuild = false;
+    target.dirtyBegin  = 0;
+    target.dirtyEnd    = offset;
+}
+
+} // namespace sf
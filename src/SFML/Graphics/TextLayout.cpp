@@ -0,0 +1,263 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2012 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Graphics/TextLayout.hpp>
+#include <SFML/Graphics/Font.hpp>
+#include <algorithm>
+
+
+namespace
+{
+    // Tell whether a character is a whitespace, which never triggers line wrapping
+    bool isWhitespace(sf::Uint32 character)
+    {
+        return (character == L' ') || (character == L'\t') || (character == L'\n') || (character == L'\v');
+    }
+}
+
+
+namespace sf
+{
+////////////////////////////////////////////////////////////
+TextLayout::TextLayout() :
+m_font         (NULL),
+m_characterSize(30),
+m_bold         (false),
+m_maxWidth     (0.f),
+m_spaceAdvance (0.f),
+m_lineSpacing  (0.f),
+m_positions    (),
+m_advances     (),
+m_lineStarts   (1, 0),
+m_pen          (),
+m_previousChar (0),
+m_breakPosition(0),
+m_width        (0.f),
+m_lineWidth    (0.f)
+{
+
+}
+
+
+////////////////////////////////////////////////////////////
+TextLayout::TextLayout(const Font& font, const String& string, unsigned int characterSize, bool bold, float maxWidth) :
+m_font         (NULL),
+m_characterSize(30),
+m_bold         (false),
+m_maxWidth     (0.f),
+m_spaceAdvance (0.f),
+m_lineSpacing  (0.f),
+m_positions    (),
+m_advances     (),
+m_lineStarts   (1, 0),
+m_pen          (),
+m_previousChar (0),
+m_breakPosition(0),
+m_width        (0.f),
+m_lineWidth    (0.f)
+{
+    reset(font, characterSize, bold, maxWidth);
+    append(string);
+}
+
+
+////////////////////////////////////////////////////////////
+void TextLayout::reset(const Font& font, unsigned int characterSize, bool bold, float maxWidth)
+{
+    m_font          = &font;
+    m_characterSize = characterSize;
+    m_bold          = bold;
+    m_maxWidth      = maxWidth;
+    m_spaceAdvance  = static_cast<float>(font.getGlyph(L' ', characterSize, bold).advance);
+    m_lineSpacing   = static_cast<float>(font.getLineSpacing(characterSize));
+
+    clear();
+}
+
+
+////////////////////////////////////////////////////////////
+void TextLayout::clear()
+{
+    m_positions.clear();
+    m_advances.clear();
+    m_lineStarts.assign(1, 0);
+    m_pen           = Vector2f();
+    m_previousChar  = 0;
+    m_breakPosition = 0;
+    m_width         = 0.f;
+    m_lineWidth     = 0.f;
+}
+
+
+////////////////////////////////////////////////////////////
+void TextLayout::append(const String& string)
+{
+    if (!m_font)
+        return;
+
+    // Grow the arrays geometrically, so that repeated appends stay linear
+    if (string.getSize() > m_positions.capacity())
+    {
+        std::size_t capacity = std::max<std::size_t>(string.getSize(), 2 * m_positions.capacity());
+        m_positions.reserve(capacity);
+        m_advances.reserve(capacity);
+    }
+
+    for (std::size_t i = m_positions.size(); i < string.getSize(); ++i)
+    {
+        Uint32 curChar = string[i];
+
+        // Apply the kerning offset
+        m_pen.x += static_cast<float>(m_font->getKerning(m_previousChar, curChar, m_characterSize));
+        m_previousChar = curChar;
+
+        // Get the advance of the character
+        float advance;
+        switch (curChar)
+        {
+            case L' ' :  advance = m_spaceAdvance;     break;
+            case L'\t' : advance = m_spaceAdvance * 4; break;
+            case L'\n' : advance = 0.f;                break;
+            case L'\v' : advance = 0.f;                break;
+            default :    advance = static_cast<float>(m_font->getGlyph(curChar, m_characterSize, m_bold).advance); break;
+        }
+
+        // Move the end of the line to a new one if the character doesn't fit
+        if ((m_maxWidth > 0.f) && !isWhitespace(curChar) && (m_pen.x + advance > m_maxWidth) && (i > m_lineStarts.back()))
+            wrap(string, i);
+
+        m_positions.push_back(m_pen);
+        m_advances.push_back(advance);
+
+        // Advance to the next character
+        switch (curChar)
+        {
+            case L'\n' :
+                m_width = std::max(m_width, m_lineWidth);
+                m_lineWidth = 0.f;
+                m_pen.x = 0.f;
+                m_pen.y += m_lineSpacing;
+                m_lineStarts.push_back(i + 1);
+                m_breakPosition = i + 1;
+                break;
+
+            case L'\v' :
+                m_pen.y += m_lineSpacing * 4;
+                break;
+
+            case L' ' :
+            case L'\t' :
+                m_pen.x += advance;
+                m_breakPosition = i + 1;
+                break;
+
+            default :
+                m_pen.x += advance;
+                m_lineWidth = m_pen.x;
+                break;
+        }
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+std::size_t TextLayout::getCharacterCount() const
+{
+    return m_positions.size();
+}
+
+
+////////////////////////////////////////////////////////////
+Vector2f TextLayout::getCharacterPosition(std::size_t index) const
+{
+    return (index < m_positions.size()) ? m_positions[index] : m_pen;
+}
+
+
+////////////////////////////////////////////////////////////
+float TextLayout::getAdvance(std::size_t index) const
+{
+    return m_advances[index];
+}
+
+
+////////////////////////////////////////////////////////////
+std::size_t TextLayout::getLineCount() const
+{
+    return m_lineStarts.size();
+}
+
+
+////////////////////////////////////////////////////////////
+std::size_t TextLayout::getLineStart(std::size_t line) const
+{
+    return m_lineStarts[line];
+}
+
+
+////////////////////////////////////////////////////////////
+Vector2f TextLayout::getSize() const
+{
+    if (m_positions.empty())
+        return Vector2f();
+
+    return Vector2f(std::max(m_width, m_lineWidth), m_pen.y + m_lineSpacing);
+}
+
+
+////////////////////////////////////////////////////////////
+void TextLayout::wrap(const String& string, std::size_t current)
+{
+    // Break after the last whitespace of the line, or before the current character if there's none
+    std::size_t lineStart = m_lineStarts.back();
+    std::size_t first = (m_breakPosition > lineStart) ? m_breakPosition : current;
+
+    // The finished line ends with its last non-whitespace character
+    float lineWidth = 0.f;
+    for (std::size_t i = first; i > lineStart; --i)
+    {
+        if (!isWhitespace(string[i - 1]))
+        {
+            lineWidth = m_positions[i - 1].x + m_advances[i - 1];
+            break;
+        }
+    }
+    m_width = std::max(m_width, lineWidth);
+
+    // Move the characters that follow the break to the beginning of the next line
+    Vector2f offset(-((first < current) ? m_positions[first].x : m_pen.x), m_lineSpacing);
+    for (std::size_t i = first; i < current; ++i)
+        m_positions[i] += offset;
+    m_pen += offset;
+
+    // The characters after the break are never whitespaces
+    m_lineWidth = (first < current) ? m_pen.x : 0.f;
+    m_lineStarts.push_back(first);
+    m_breakPosition = first;
+}
+
+} // namespace sf
@@ -29,6 +29,8 @@
 #include <SFML/Graphics/Image.hpp>
 #include <SFML/Graphics/GLCheck.hpp>
 #include <SFML/Graphics/TextureSaver.hpp>
+#include <SFML/Graphics/PixelBuffer.hpp>
+#include <SFML/Graphics/RenderTarget.hpp>
 #include <SFML/Window/Window.hpp>
 #include <SFML/System/Mutex.hpp>
 #include <SFML/System/Lock.hpp>
@@ -39,6 +41,9 @@
 
 namespace
 {
+    // Number of pixel buffers used in turn by asynchronous updates
+    const std::size_t uploadBufferCount = 3;
+
     // Thread-safe unique identifier generator,
     // is used for states cache (see RenderTarget)
     sf::Uint64 getUniqueId()
@@ -49,6 +54,80 @@ namespace
         sf::Lock lock(mutex);
         return id++;
     }
+
+    // Check whether alpha textures can use a single-channel storage; it must
+    // be sampled as white, which requires swizzling its color components
+    bool hasAlphaStorage()
+    {
+        sf::priv::ensureGlewInit();
+
+        return GLEW_ARB_texture_swizzle || GLEW_EXT_texture_swizzle;
+    }
+
+    // Extract the alpha components of the pixels of an image
+    void getAlphaComponents(const sf::Image& image, std::vector<sf::Uint8>& alpha)
+    {
+        const sf::Uint8* pixels = image.getPixelsPtr();
+        alpha.resize(image.getSize().x * image.getSize().y);
+        for (std::size_t i = 0; i < alpha.size(); ++i)
+            alpha[i] = pixels[i * 4 + 3];
+    }
+
+    // Copy an area of a texture to another one, using frame buffer objects;
+    // coordinates are in storage space (not flipped), and the area is flipped
+    // vertically if requested. Returns false if the system can't do it
+    bool copyOnGpu(GLuint source, const sf::IntRect& area, GLuint destination, GLint x, GLint y, bool flip)
+    {
+        // Make sure that GLEW is initialized
+        sf::priv::ensureGlewInit();
+
+        if (!GLEW_EXT_framebuffer_object || (flip && !GLEW_EXT_framebuffer_blit))
+            return false;
+
+        // Make sure that the current frame buffer binding will be preserved
+        GLint previousFrameBuffer;
+        glCheck(glGetIntegerv(GL_FRAMEBUFFER_BINDING_EXT, &previousFrameBuffer));
+
+        // Frame buffers can't be shared between contexts, so they are created for this copy only
+        GLuint frameBuffers[2] = {0, 0};
+        glCheck(glGenFramebuffersEXT(2, frameBuffers));
+
+        bool success = false;
+        if (!flip)
+        {
+            // Attach the source texture to a frame buffer, and read from it into the destination texture
+            glCheck(glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, frameBuffers[0]));
+            glCheck(glFramebufferTexture2DEXT(GL_FRAMEBUFFER_EXT, GL_COLOR_ATTACHMENT0_EXT, GL_TEXTURE_2D, source, 0));
+            if (glCheckFramebufferStatusEXT(GL_FRAMEBUFFER_EXT) == GL_FRAMEBUFFER_COMPLETE_EXT)
+            {
+                sf::priv::TextureSaver save;
+                glCheck(glBindTexture(GL_TEXTURE_2D, destination));
+                glCheck(glCopyTexSubImage2D(GL_TEXTURE_2D, 0, x, y, area.left, area.top, area.width, area.height));
+                success = true;
+            }
+        }
+        else
+        {
+            // Attach both textures to frame buffers, and blit with the Y axis inverted
+            glCheck(glBindFramebufferEXT(GL_READ_FRAMEBUFFER_EXT, frameBuffers[0]));
+            glCheck(glFramebufferTexture2DEXT(GL_READ_FRAMEBUFFER_EXT, GL_COLOR_ATTACHMENT0_EXT, GL_TEXTURE_2D, source, 0));
+            glCheck(glBindFramebufferEXT(GL_DRAW_FRAMEBUFFER_EXT, frameBuffers[1]));
+            glCheck(glFramebufferTexture2DEXT(GL_DRAW_FRAMEBUFFER_EXT, GL_COLOR_ATTACHMENT0_EXT, GL_TEXTURE_2D, destination, 0));
+            if ((glCheckFramebufferStatusEXT(GL_READ_FRAMEBUFFER_EXT) == GL_FRAMEBUFFER_COMPLETE_EXT) &&
+                (glCheckFramebufferStatusEXT(GL_DRAW_FRAMEBUFFER_EXT) == GL_FRAMEBUFFER_COMPLETE_EXT))
+            {
+                glCheck(glBlitFramebufferEXT(area.left, area.top, area.left + area.width, area.top + area.height,
+                                             x, y + area.height, x + area.width, y,
+                                             GL_COLOR_BUFFER_BIT, GL_NEAREST));
+                success = true;
+            }
+        }
+
+        glCheck(glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, previousFrameBuffer));
+        glCheck(glDeleteFramebuffersEXT(2, frameBuffers));
+
+        return success;
+    }
 }
 
 
@@ -59,10 +138,13 @@ Texture::Texture() :
 m_size         (0, 0),
 m_actualSize   (0, 0),
 m_texture      (0),
+m_format       (Rgba),
 m_isSmooth     (false),
 m_isRepeated   (false),
 m_pixelsFlipped(false),
-m_cacheId      (getUniqueId())
+m_cacheId      (getUniqueId()),
+m_uploadBuffers(),
+m_uploadCount  (0)
 {
 
 }
@@ -73,13 +155,25 @@ Texture::Texture(const Texture& copy) :
 m_size         (0, 0),
 m_actualSize   (0, 0),
 m_texture      (0),
+m_format       (copy.m_format),
 m_isSmooth     (copy.m_isSmooth),
 m_isRepeated   (copy.m_isRepeated),
 m_pixelsFlipped(false),
-m_cacheId      (getUniqueId())
+m_cacheId      (getUniqueId()),
+m_uploadBuffers(),
+m_uploadCount  (0)
 {
-    if (copy.m_texture)
-        loadFromImage(copy.copyToImage());
+    if (copy.m_texture && create(copy.m_size.x, copy.m_size.y, copy.m_format))
+    {
+        ensureGlContext();
+
+        // Copy the whole storage as is, on the graphics card if possible
+        IntRect area(0, 0, m_actualSize.x, m_actualSize.y);
+        if (copyOnGpu(copy.m_texture, area, m_texture, 0, 0, false))
+            m_pixelsFlipped = copy.m_pixelsFlipped;
+        else
+            update(copy.copyToImage());
+    }
 }
 
 
@@ -94,11 +188,15 @@ Texture::~Texture()
         GLuint texture = static_cast<GLuint>(m_texture);
         glCheck(glDeleteTextures(1, &texture));
     }
+
+    // Destroy the pixel buffers
+    for (std::vector<priv::PixelBuffer*>::iterator it = m_uploadBuffers.begin(); it != m_uploadBuffers.end(); ++it)
+        delete *it;
 }
 
 
 ////////////////////////////////////////////////////////////
-bool Texture::create(unsigned int width, unsigned int height)
+bool Texture::create(unsigned int width, unsigned int height, PixelFormat format)
 {
     // Check if texture parameters are valid before creating it
     if ((width == 0) || (height == 0))
@@ -125,6 +223,7 @@ bool Texture::create(unsigned int width, unsigned int height)
     m_size.x        = width;
     m_size.y        = height;
     m_actualSize    = actualSize;
+    m_format        = format;
     m_pixelsFlipped = false;
 
     ensureGlContext();
@@ -141,8 +240,22 @@ bool Texture::create(unsigned int width, unsigned int height)
     priv::TextureSaver save;
 
     // Initialize the texture
+    bool swizzle = hasAlphaStorage();
     glCheck(glBindTexture(GL_TEXTURE_2D, m_texture));
-    glCheck(glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, m_actualSize.x, m_actualSize.y, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL));
+    if (m_format == Rgba)
+        glCheck(glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, m_actualSize.x, m_actualSize.y, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL));
+    else if (swizzle)
+        glCheck(glTexImage2D(GL_TEXTURE_2D, 0, GL_ALPHA8, m_actualSize.x, m_actualSize.y, 0, GL_ALPHA, GL_UNSIGNED_BYTE, NULL));
+    else
+        glCheck(glTexImage2D(GL_TEXTURE_2D, 0, GL_LUMINANCE8_ALPHA8, m_actualSize.x, m_actualSize.y, 0, GL_LUMINANCE_ALPHA, GL_UNSIGNED_BYTE, NULL));
+    if (swizzle)
+    {
+        // Alpha textures are sampled as white, both by the fixed pipeline and by shaders
+        GLint components[4] = {GL_RED, GL_GREEN, GL_BLUE, GL_ALPHA};
+        if (m_format == Alpha)
+            components[0] = components[1] = components[2] = GL_ONE;
+        glCheck(glTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_RGBA, components));
+    }
     glCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, m_isRepeated ? GL_REPEAT : GL_CLAMP_TO_EDGE));
     glCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, m_isRepeated ? GL_REPEAT : GL_CLAMP_TO_EDGE));
     glCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, m_isSmooth ? GL_LINEAR : GL_NEAREST));
@@ -242,6 +355,13 @@ Vector2u Texture::getSize() const
 }
 
 
+////////////////////////////////////////////////////////////
+Texture::PixelFormat Texture::getPixelFormat() const
+{
+    return m_format;
+}
+
+
 ////////////////////////////////////////////////////////////
 Image Texture::copyToImage() const
 {
@@ -293,6 +413,13 @@ Image Texture::copyToImage() const
         }
     }
 
+    // Alpha textures are white, whatever their storage returns for the color components
+    if (m_format == Alpha)
+    {
+        for (std::size_t i = 0; i < pixels.size(); i += 4)
+            pixels[i] = pixels[i + 1] = pixels[i + 2] = 255;
+    }
+
     // Create the image
     Image image;
     image.create(m_size.x, m_size.y, &pixels[0]);
@@ -324,7 +451,7 @@ void Texture::update(const Uint8* pixels, unsigned int width, unsigned int heigh
 
         // Copy pixels from the given array to the texture
         glCheck(glBindTexture(GL_TEXTURE_2D, m_texture));
-        glCheck(glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixels));
+        uploadPixels(pixels, width, height, x, y);
         m_pixelsFlipped = false;
         m_cacheId = getUniqueId();
     }
@@ -335,14 +462,23 @@ void Texture::update(const Uint8* pixels, unsigned int width, unsigned int heigh
 void Texture::update(const Image& image)
 {
     // Update the whole texture
-    update(image.getPixelsPtr(), image.getSize().x, image.getSize().y, 0, 0);
+    update(image, 0, 0);
 }
 
 
 ////////////////////////////////////////////////////////////
 void Texture::update(const Image& image, unsigned int x, unsigned int y)
 {
-    update(image.getPixelsPtr(), image.getSize().x, image.getSize().y, x, y);
+    if (m_format == Rgba)
+    {
+        update(image.getPixelsPtr(), image.getSize().x, image.getSize().y, x, y);
+    }
+    else if (m_texture)
+    {
+        std::vector<Uint8> alpha;
+        getAlphaComponents(image, alpha);
+        update(alpha.empty() ? NULL : &alpha[0], image.getSize().x, image.getSize().y, x, y);
+    }
 }
 
 
@@ -359,6 +495,11 @@ void Texture::update(const Window& window, unsigned int x, unsigned int y)
     assert(x + window.getSize().x <= m_size.x);
     assert(y + window.getSize().y <= m_size.y);
 
+    // Render the pending primitives of a render window, so that they are part of the copied pixels
+    const RenderTarget* target = dynamic_cast<const RenderTarget*>(&window);
+    if (target)
+        const_cast<RenderTarget*>(target)->flush();
+
     if (m_texture && window.setActive(true))
     {
         // Make sure that the current texture binding will be preserved
@@ -373,6 +514,173 @@ void Texture::update(const Window& window, unsigned int x, unsigned int y)
 }
 
 
+////////////////////////////////////////////////////////////
+void Texture::copy(const Texture& source, unsigned int destX, unsigned int destY, const IntRect& sourceRect)
+{
+    // Make sure that both textures are valid
+    if (!m_texture || !source.m_texture)
+        return;
+
+    // Adjust the source rectangle
+    IntRect srcRect = sourceRect;
+    if (srcRect.width == 0 || (srcRect.height == 0))
+    {
+        srcRect.left   = 0;
+        srcRect.top    = 0;
+        srcRect.width  = source.m_size.x;
+        srcRect.height = source.m_size.y;
+    }
+    else
+    {
+        if (srcRect.left   < 0) srcRect.left = 0;
+        if (srcRect.top    < 0) srcRect.top  = 0;
+        if (srcRect.left + srcRect.width > static_cast<int>(source.m_size.x)) srcRect.width  = source.m_size.x - srcRect.left;
+        if (srcRect.top + srcRect.height > static_cast<int>(source.m_size.y)) srcRect.height = source.m_size.y - srcRect.top;
+    }
+
+    // Make sure the source area is valid
+    if ((srcRect.width <= 0) || (srcRect.height <= 0))
+        return;
+
+    // Then find the valid bounds of the destination rectangle
+    int width  = srcRect.width;
+    int height = srcRect.height;
+    if (destX + width  > m_size.x) width  = m_size.x - destX;
+    if (destY + height > m_size.y) height = m_size.y - destY;
+
+    // Make sure the destination area is valid
+    if ((width <= 0) || (height <= 0))
+        return;
+
+    // A texture can't be both the source and the target of a frame buffer
+    // copy, so copy the area out of it first when the two are the same
+    if (&source == this)
+    {
+        Texture area;
+        if (area.create(width, height, m_format))
+        {
+            area.copy(*this, 0, 0, IntRect(srcRect.left, srcRect.top, width, height));
+            copy(area, destX, destY);
+        }
+        return;
+    }
+
+    ensureGlContext();
+
+    // Convert the coordinates to the storage space of each texture
+    int sourceY = source.m_pixelsFlipped ? source.m_size.y - srcRect.top - height : srcRect.top;
+    int targetY = m_pixelsFlipped ? m_size.y - destY - height : destY;
+    bool flip = (source.m_pixelsFlipped != m_pixelsFlipped);
+
+    // A luminance-alpha storage would take the luminance from the red component of the source
+    bool gpuCopy = (m_format == Rgba) || hasAlphaStorage();
+
+    if (!gpuCopy || !copyOnGpu(source.m_texture, IntRect(srcRect.left, sourceY, width, height), m_texture, destX, targetY, flip))
+    {
+        // Fall back to a copy through the system memory
+        Image pixels;
+        pixels.create(width, height);
+        pixels.copy(source.copyToImage(), 0, 0, IntRect(srcRect.left, srcRect.top, width, height));
+        if (m_pixelsFlipped)
+            pixels.flipVertically();
+
+        // Make sure that the current texture binding will be preserved
+        priv::TextureSaver save;
+
+        std::vector<Uint8> alpha;
+        if (m_format == Alpha)
+            getAlphaComponents(pixels, alpha);
+
+        glCheck(glBindTexture(GL_TEXTURE_2D, m_texture));
+        uploadPixels(alpha.empty() ? pixels.getPixelsPtr() : &alpha[0], width, height, destX, targetY);
+    }
+
+    m_cacheId = getUniqueId();
+}
+
+
+////////////////////////////////////////////////////////////
+Uint64 Texture::updateAsync(const Uint8* pixels, unsigned int width, unsigned int height, unsigned int x, unsigned int y)
+{
+    assert(x + width <= m_size.x);
+    assert(y + height <= m_size.y);
+
+    if (!pixels || !m_texture)
+        return 0;
+
+    ensureGlContext();
+
+    // Fall back to a synchronous update if pixel buffers are not supported,
+    // or if the pixels have to be converted to a luminance-alpha storage
+    if (!priv::PixelBuffer::isAvailable() || ((m_format == Alpha) && !hasAlphaStorage()))
+    {
+        update(pixels, width, height, x, y);
+        return ++m_uploadCount;
+    }
+
+    // Create the pixel buffers on first use
+    if (m_uploadBuffers.empty())
+    {
+        for (std::size_t i = 0; i < uploadBufferCount; ++i)
+            m_uploadBuffers.push_back(new priv::PixelBuffer(priv::PixelBuffer::Upload));
+    }
+
+    // Use the buffers in turn; the storage is orphaned, so we never wait
+    // for a previous transfer that still reads from the same buffer
+    Uint64 ticket = ++m_uploadCount;
+    priv::PixelBuffer& buffer = *m_uploadBuffers[(ticket - 1) % m_uploadBuffers.size()];
+    std::size_t size = static_cast<std::size_t>(width) * height * (m_format == Rgba ? 4 : 1);
+
+    void* data = buffer.allocate(size) ? buffer.map() : NULL;
+    if (!data)
+    {
+        update(pixels, width, height, x, y);
+        return ticket;
+    }
+    std::memcpy(data, pixels, size);
+    buffer.unmap();
+
+    // Make sure that the current texture binding will be preserved
+    priv::TextureSaver save;
+
+    // Start the transfer from the buffer to the texture
+    buffer.bind();
+    glCheck(glBindTexture(GL_TEXTURE_2D, m_texture));
+    uploadPixels(NULL, width, height, x, y);
+    buffer.unbind();
+    buffer.fence();
+
+    m_pixelsFlipped = false;
+    m_cacheId = getUniqueId();
+
+    return ticket;
+}
+
+
+////////////////////////////////////////////////////////////
+Uint64 Texture::updateAsync(const Image& image, unsigned int x, unsigned int y)
+{
+    if (m_format == Rgba)
+        return updateAsync(image.getPixelsPtr(), image.getSize().x, image.getSize().y, x, y);
+
+    std::vector<Uint8> alpha;
+    getAlphaComponents(image, alpha);
+    return updateAsync(alpha.empty() ? NULL : &alpha[0], image.getSize().x, image.getSize().y, x, y);
+}
+
+
+////////////////////////////////////////////////////////////
+bool Texture::isUpdateComplete(Uint64 ticket) const
+{
+    if ((ticket == 0) || (ticket > m_uploadCount) || m_uploadBuffers.empty())
+        return true;
+
+    // If the buffer was reused since then, its fence belongs to a more recent
+    // update; since updates finish in order, it's still a valid answer
+    return m_uploadBuffers[(ticket - 1) % m_uploadBuffers.size()]->isReady();
+}
+
+
 ////////////////////////////////////////////////////////////
 void Texture::bind(CoordinateType coordinateType) const
 {
@@ -487,18 +795,31 @@ Texture& Texture::operator =(const Texture& right)
 {
     Texture temp(right);
 
-    std::swap(m_size,          temp.m_size);
-    std::swap(m_actualSize,    temp.m_actualSize);
-    std::swap(m_texture,       temp.m_texture);
-    std::swap(m_isSmooth,      temp.m_isSmooth);
-    std::swap(m_isRepeated,    temp.m_isRepeated);
-    std::swap(m_pixelsFlipped, temp.m_pixelsFlipped);
-    m_cacheId = getUniqueId();
+    swap(temp);
 
     return *this;
 }
 
 
+////////////////////////////////////////////////////////////
+void Texture::swap(Texture& right)
+{
+    std::swap(m_size,          right.m_size);
+    std::swap(m_actualSize,    right.m_actualSize);
+    std::swap(m_texture,       right.m_texture);
+    std::swap(m_format,        right.m_format);
+    std::swap(m_isSmooth,      right.m_isSmooth);
+    std::swap(m_isRepeated,    right.m_isRepeated);
+    std::swap(m_pixelsFlipped, right.m_pixelsFlipped);
+    std::swap(m_uploadBuffers, right.m_uploadBuffers);
+    std::swap(m_uploadCount,   right.m_uploadCount);
+
+    // Both textures changed, the render targets must not consider them as already bound
+    m_cacheId       = getUniqueId();
+    right.m_cacheId = getUniqueId();
+}
+
+
 ////////////////////////////////////////////////////////////
 unsigned int Texture::getValidSize(unsigned int size)
 {
@@ -523,4 +844,36 @@ unsigned int Texture::getValidSize(unsigned int size)
     }
 }
 
+
+////////////////////////////////////////////////////////////
+void Texture::uploadPixels(const Uint8* pixels, unsigned int width, unsigned int height, unsigned int x, unsigned int y)
+{
+    if (m_format == Rgba)
+    {
+        glCheck(glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixels));
+        return;
+    }
+
+    // Without a single-channel storage, alpha values are expanded to white luminance-alpha pixels
+    // (pixels can be NULL when they come from a pixel buffer, but such buffers are not used in this case)
+    std::vector<Uint8> expanded;
+    GLenum format = GL_ALPHA;
+    if (pixels && !hasAlphaStorage())
+    {
+        expanded.resize(static_cast<std::size_t>(width) * height * 2, 255);
+        for (std::size_t i = 0; i < expanded.size() / 2; ++i)
+            expanded[i * 2 + 1] = pixels[i];
+
+        pixels = &expanded[0];
+        format = GL_LUMINANCE_ALPHA;
+    }
+
+    // Rows of 8 and 16 bits pixels are not aligned on 4 bytes
+    GLint alignment;
+    glCheck(glGetIntegerv(GL_UNPACK_ALIGNMENT, &alignment));
+    glCheck(glPixelStorei(GL_UNPACK_ALIGNMENT, 1));
+    glCheck(glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, width, height, format, GL_UNSIGNED_BYTE, pixels));
+    glCheck(glPixelStorei(GL_UNPACK_ALIGNMENT, alignment));
+}
+
 } // namespace sf
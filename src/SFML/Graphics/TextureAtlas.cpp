@@ -0,0 +1,373 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2012 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Graphics/TextureAtlas.hpp>
+#include <SFML/Graphics/Texture.hpp>
+#include <SFML/Graphics/SkylinePacker.hpp>
+#include <SFML/System/Err.hpp>
+#include <algorithm>
+
+
+namespace
+{
+    // Order used to repack the entries: tallest first, then widest first
+    struct EntryHeightGreater
+    {
+        template <typename T>
+        bool operator ()(const T* left, const T* right) const
+        {
+            if (left->second.rect.height != right->second.rect.height)
+                return left->second.rect.height > right->second.rect.height;
+            return left->second.rect.width > right->second.rect.width;
+        }
+    };
+
+    // Clamp a coordinate to the range [0, size - 1]
+    unsigned int clampCoordinate(int value, unsigned int size)
+    {
+        if (value < 0)
+            return 0;
+        if (static_cast<unsigned int>(value) >= size)
+            return size - 1;
+        return static_cast<unsigned int>(value);
+    }
+}
+
+
+namespace sf
+{
+////////////////////////////////////////////////////////////
+struct TextureAtlas::Page
+{
+    Texture             texture; ///< Texture holding the pixels of the page
+    priv::SkylinePacker packer;  ///< Free space of the page
+};
+
+
+////////////////////////////////////////////////////////////
+TextureAtlas::TextureAtlas() :
+m_pages    (),
+m_entries  (),
+m_nextId   (1),
+m_pageSize (1024),
+m_padding  (1),
+m_extrusion(0),
+m_isSmooth (false)
+{
+}
+
+
+////////////////////////////////////////////////////////////
+TextureAtlas::TextureAtlas(unsigned int pageSize) :
+m_pages    (),
+m_entries  (),
+m_nextId   (1),
+m_pageSize (pageSize),
+m_padding  (1),
+m_extrusion(0),
+m_isSmooth (false)
+{
+}
+
+
+////////////////////////////////////////////////////////////
+TextureAtlas::~TextureAtlas()
+{
+    clear();
+}
+
+
+////////////////////////////////////////////////////////////
+unsigned int TextureAtlas::add(const Image& image)
+{
+    return add(image, IntRect());
+}
+
+
+////////////////////////////////////////////////////////////
+unsigned int TextureAtlas::add(const Image& image, const IntRect& sourceRect)
+{
+    // Adjust the source rectangle
+    IntRect rect = sourceRect;
+    Vector2u size = image.getSize();
+    if (rect.width == 0 || rect.height == 0)
+        rect = IntRect(0, 0, size.x, size.y);
+    if (!rect.intersects(IntRect(0, 0, size.x, size.y), rect))
+    {
+        err() << "Failed to add image to texture atlas: the image is empty" << std::endl;
+        return 0;
+    }
+
+    // Keep a copy of the pixels, so that the entry can be uploaded again on repack
+    Entry entry;
+    entry.image.create(rect.width, rect.height);
+    entry.image.copy(image, 0, 0, rect);
+    entry.page = 0;
+
+    if (!insert(entry))
+        return 0;
+
+    unsigned int id = m_nextId++;
+    m_entries.insert(std::make_pair(id, entry));
+
+    return id;
+}
+
+
+////////////////////////////////////////////////////////////
+void TextureAtlas::remove(unsigned int id)
+{
+    m_entries.erase(id);
+}
+
+
+////////////////////////////////////////////////////////////
+void TextureAtlas::clear()
+{
+    for (std::vector<Page*>::iterator it = m_pages.begin(); it != m_pages.end(); ++it)
+        delete *it;
+
+    m_pages.clear();
+    m_entries.clear();
+}
+
+
+////////////////////////////////////////////////////////////
+void TextureAtlas::repack()
+{
+    // Sort the entries, inserting the tallest ones first gives a flatter skyline
+    std::vector<EntryTable::value_type*> sorted;
+    sorted.reserve(m_entries.size());
+    for (EntryTable::iterator it = m_entries.begin(); it != m_entries.end(); ++it)
+        sorted.push_back(&*it);
+    std::sort(sorted.begin(), sorted.end(), EntryHeightGreater());
+
+    // Destroy all the pages; the ones that are still needed are created again by insert()
+    for (std::vector<Page*>::iterator it = m_pages.begin(); it != m_pages.end(); ++it)
+        delete *it;
+    m_pages.clear();
+
+    // Insert the entries again
+    for (std::vector<EntryTable::value_type*>::iterator it = sorted.begin(); it != sorted.end(); ++it)
+    {
+        if (!insert((*it)->second))
+            m_entries.erase((*it)->first);
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+bool TextureAtlas::contains(unsigned int id) const
+{
+    return m_entries.find(id) != m_entries.end();
+}
+
+
+////////////////////////////////////////////////////////////
+const Texture& TextureAtlas::getTexture(unsigned int id) const
+{
+    EntryTable::const_iterator it = m_entries.find(id);
+    if (it != m_entries.end())
+        return m_pages[it->second.page]->texture;
+
+    static const Texture empty;
+    return empty;
+}
+
+
+////////////////////////////////////////////////////////////
+IntRect TextureAtlas::getTextureRect(unsigned int id) const
+{
+    EntryTable::const_iterator it = m_entries.find(id);
+    return it != m_entries.end() ? it->second.rect : IntRect();
+}
+
+
+////////////////////////////////////////////////////////////
+unsigned int TextureAtlas::getPageCount() const
+{
+    return static_cast<unsigned int>(m_pages.size());
+}
+
+
+////////////////////////////////////////////////////////////
+const Texture& TextureAtlas::getPage(unsigned int index) const
+{
+    return m_pages[index]->texture;
+}
+
+
+////////////////////////////////////////////////////////////
+unsigned int TextureAtlas::getPageSize() const
+{
+    return m_pageSize;
+}
+
+
+////////////////////////////////////////////////////////////
+float TextureAtlas::getFillRatio() const
+{
+    if (m_pages.empty())
+        return 0.f;
+
+    float used = 0.f;
+    for (EntryTable::const_iterator it = m_entries.begin(); it != m_entries.end(); ++it)
+        used += static_cast<float>(it->second.rect.width) * it->second.rect.height;
+
+    float total = 0.f;
+    for (std::vector<Page*>::const_iterator it = m_pages.begin(); it != m_pages.end(); ++it)
+        total += static_cast<float>((*it)->texture.getSize().x) * (*it)->texture.getSize().y;
+
+    return used / total;
+}
+
+
+////////////////////////////////////////////////////////////
+void TextureAtlas::setPadding(unsigned int padding)
+{
+    m_padding = padding;
+}
+
+
+////////////////////////////////////////////////////////////
+unsigned int TextureAtlas::getPadding() const
+{
+    return m_padding;
+}
+
+
+////////////////////////////////////////////////////////////
+void TextureAtlas::setExtrusion(unsigned int extrusion)
+{
+    m_extrusion = extrusion;
+}
+
+
+////////////////////////////////////////////////////////////
+unsigned int TextureAtlas::getExtrusion() const
+{
+    return m_extrusion;
+}
+
+
+////////////////////////////////////////////////////////////
+void TextureAtlas::setSmooth(bool smooth)
+{
+    m_isSmooth = smooth;
+
+    for (std::vector<Page*>::iterator it = m_pages.begin(); it != m_pages.end(); ++it)
+        (*it)->texture.setSmooth(smooth);
+}
+
+
+////////////////////////////////////////////////////////////
+bool TextureAtlas::isSmooth() const
+{
+    return m_isSmooth;
+}
+
+
+////////////////////////////////////////////////////////////
+bool TextureAtlas::insert(Entry& entry)
+{
+    // The extruded border is part of the uploaded block, the padding is just left empty
+    Vector2u imageSize = entry.image.getSize();
+    unsigned int blockWidth  = imageSize.x + 2 * m_extrusion;
+    unsigned int blockHeight = imageSize.y + 2 * m_extrusion;
+
+    unsigned int maxSize = std::min(m_pageSize, Texture::getMaximumSize());
+    if ((blockWidth > maxSize) || (blockHeight > maxSize))
+    {
+        err() << "Failed to add image to texture atlas: its size (" << imageSize.x << "x" << imageSize.y
+              << ") doesn't fit in a page (" << maxSize << "x" << maxSize << ")" << std::endl;
+        return false;
+    }
+
+    // The padding is only added to the right and bottom, unless it makes the block too big for a page
+    unsigned int paddedWidth  = std::min(blockWidth + m_padding, maxSize);
+    unsigned int paddedHeight = std::min(blockHeight + m_padding, maxSize);
+
+    // Find a page with enough space, or create a new one
+    Vector2u position;
+    unsigned int page = 0;
+    while ((page < m_pages.size()) && !m_pages[page]->packer.insert(paddedWidth, paddedHeight, position))
+        ++page;
+    if (page == m_pages.size())
+    {
+        page = createPage();
+        if (!m_pages[page]->packer.insert(paddedWidth, paddedHeight, position))
+            return false;
+    }
+
+    // Build the block to upload: the image surrounded by copies of its border pixels
+    if (m_extrusion > 0)
+    {
+        Image block;
+        block.create(blockWidth, blockHeight);
+        for (unsigned int y = 0; y < blockHeight; ++y)
+        {
+            unsigned int sourceY = clampCoordinate(static_cast<int>(y) - static_cast<int>(m_extrusion), imageSize.y);
+            for (unsigned int x = 0; x < blockWidth; ++x)
+            {
+                unsigned int sourceX = clampCoordinate(static_cast<int>(x) - static_cast<int>(m_extrusion), imageSize.x);
+                block.setPixel(x, y, entry.image.getPixel(sourceX, sourceY));
+            }
+        }
+        m_pages[page]->texture.update(block, position.x, position.y);
+    }
+    else
+    {
+        m_pages[page]->texture.update(entry.image, position.x, position.y);
+    }
+
+    entry.page = page;
+    entry.rect = IntRect(position.x + m_extrusion, position.y + m_extrusion, imageSize.x, imageSize.y);
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+unsigned int TextureAtlas::createPage()
+{
+    unsigned int size = std::min(m_pageSize, Texture::getMaximumSize());
+
+    // Start from a transparent texture, so that the padding doesn't contain garbage
+    Image pixels;
+    pixels.create(size, size, Color(0, 0, 0, 0));
+
+    Page* page = new Page;
+    page->texture.loadFromImage(pixels);
+    page->texture.setSmooth(m_isSmooth);
+    page->packer.clear(size, size);
+    m_pages.push_back(page);
+
+    return static_cast<unsigned int>(m_pages.size() - 1);
+}
+
+} // namespace sf
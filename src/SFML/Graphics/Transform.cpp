@@ -26,8 +26,16 @@
 // Headers
 ////////////////////////////////////////////////////////////
 #include <SFML/Graphics/Transform.hpp>
+#include <SFML/Graphics/Vertex.hpp>
+#include <cstring>
 #include <cmath>
 
+// SSE2 is always available on x86-64, and can be enabled with a compiler flag on x86
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+    #define SFML_TRANSFORM_USE_SSE2
+    #include <emmintrin.h>
+#endif
+
 
 namespace sf
 {
@@ -109,6 +117,79 @@ Vector2f Transform::transformPoint(const Vector2f& point) const
 }
 
 
+////////////////////////////////////////////////////////////
+void Transform::transformPoints(const Vector2f* points, Vector2f* result, std::size_t count) const
+{
+    std::size_t i = 0;
+
+#ifdef SFML_TRANSFORM_USE_SSE2
+
+    // Process two points per register: (x0, y0, x1, y1)
+    const __m128 a = _mm_setr_ps(m_matrix[0],  m_matrix[1],  m_matrix[0],  m_matrix[1]);
+    const __m128 b = _mm_setr_ps(m_matrix[4],  m_matrix[5],  m_matrix[4],  m_matrix[5]);
+    const __m128 c = _mm_setr_ps(m_matrix[12], m_matrix[13], m_matrix[12], m_matrix[13]);
+
+    const float* in  = &points[0].x;
+    float*       out = &result[0].x;
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 p0 = _mm_loadu_ps(in + i * 2);
+        __m128 p1 = _mm_loadu_ps(in + i * 2 + 4);
+        __m128 x0 = _mm_shuffle_ps(p0, p0, _MM_SHUFFLE(2, 2, 0, 0));
+        __m128 y0 = _mm_shuffle_ps(p0, p0, _MM_SHUFFLE(3, 3, 1, 1));
+        __m128 x1 = _mm_shuffle_ps(p1, p1, _MM_SHUFFLE(2, 2, 0, 0));
+        __m128 y1 = _mm_shuffle_ps(p1, p1, _MM_SHUFFLE(3, 3, 1, 1));
+        _mm_storeu_ps(out + i * 2,     _mm_add_ps(_mm_add_ps(_mm_mul_ps(a, x0), _mm_mul_ps(b, y0)), c));
+        _mm_storeu_ps(out + i * 2 + 4, _mm_add_ps(_mm_add_ps(_mm_mul_ps(a, x1), _mm_mul_ps(b, y1)), c));
+    }
+
+#endif
+
+    // Remaining points (or all of them, if SSE2 is not available)
+    for (; i < count; ++i)
+        result[i] = transformPoint(points[i].x, points[i].y);
+}
+
+
+////////////////////////////////////////////////////////////
+void Transform::transformPoints(const Vertex* vertices, Vertex* result, std::size_t count) const
+{
+    // Copy the colors and texture coordinates in one go, the
+    // positions are then transformed in place in the result array
+    if (result != vertices)
+        std::memcpy(result, vertices, count * sizeof(Vertex));
+
+    std::size_t i = 0;
+
+#ifdef SFML_TRANSFORM_USE_SSE2
+
+    // Positions are not contiguous: gather the positions of two vertices
+    // in the low and high halves of a register, and scatter them back
+    const __m128 a = _mm_setr_ps(m_matrix[0],  m_matrix[1],  m_matrix[0],  m_matrix[1]);
+    const __m128 b = _mm_setr_ps(m_matrix[4],  m_matrix[5],  m_matrix[4],  m_matrix[5]);
+    const __m128 c = _mm_setr_ps(m_matrix[12], m_matrix[13], m_matrix[12], m_matrix[13]);
+
+    for (; i + 2 <= count; i += 2)
+    {
+        __m128 p = _mm_setzero_ps();
+        p = _mm_loadl_pi(p, reinterpret_cast<const __m64*>(&result[i].position));
+        p = _mm_loadh_pi(p, reinterpret_cast<const __m64*>(&result[i + 1].position));
+        __m128 x = _mm_shuffle_ps(p, p, _MM_SHUFFLE(2, 2, 0, 0));
+        __m128 y = _mm_shuffle_ps(p, p, _MM_SHUFFLE(3, 3, 1, 1));
+        p = _mm_add_ps(_mm_add_ps(_mm_mul_ps(a, x), _mm_mul_ps(b, y)), c);
+
+        _mm_storel_pi(reinterpret_cast<__m64*>(&result[i].position), p);
+        _mm_storeh_pi(reinterpret_cast<__m64*>(&result[i + 1].position), p);
+    }
+
+#endif
+
+    // Remaining vertices (or all of them, if SSE2 is not available)
+    for (; i < count; ++i)
+        result[i].position = transformPoint(result[i].position.x, result[i].position.y);
+}
+
+
 ////////////////////////////////////////////////////////////
 FloatRect Transform::transformRect(const FloatRect& rectangle) const
 {
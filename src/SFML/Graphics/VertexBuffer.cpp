@@ -0,0 +1,234 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2012 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Graphics/VertexBuffer.hpp>
+#include <SFML/Graphics/RenderTarget.hpp>
+#include <SFML/Graphics/GLCheck.hpp>
+#include <SFML/System/Err.hpp>
+
+
+namespace
+{
+    // Convert a usage hint to its OpenGL equivalent
+    GLenum getGlUsage(sf::VertexBuffer::Usage usage)
+    {
+        switch (usage)
+        {
+            case sf::VertexBuffer::Static :  return GL_STATIC_DRAW_ARB;
+            case sf::VertexBuffer::Dynamic : return GL_DYNAMIC_DRAW_ARB;
+            default :                        return GL_STREAM_DRAW_ARB;
+        }
+    }
+}
+
+
+namespace sf
+{
+////////////////////////////////////////////////////////////
+VertexBuffer::VertexBuffer() :
+m_buffer       (0),
+m_size         (0),
+m_primitiveType(Points),
+m_usage        (Stream)
+{
+}
+
+
+////////////////////////////////////////////////////////////
+VertexBuffer::VertexBuffer(PrimitiveType type, Usage usage) :
+m_buffer       (0),
+m_size         (0),
+m_primitiveType(type),
+m_usage        (usage)
+{
+}
+
+
+////////////////////////////////////////////////////////////
+VertexBuffer::~VertexBuffer()
+{
+    // Destroy the OpenGL buffer
+    if (m_buffer)
+    {
+        ensureGlContext();
+
+        GLuint buffer = static_cast<GLuint>(m_buffer);
+        glCheck(glDeleteBuffersARB(1, &buffer));
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+bool VertexBuffer::create(unsigned int vertexCount)
+{
+    ensureGlContext();
+
+    if (!isAvailable())
+    {
+        err() << "Failed to create vertex buffer: your system doesn't support vertex buffers "
+              << "(you should test VertexBuffer::isAvailable() before trying to use the VertexBuffer class)" << std::endl;
+        return false;
+    }
+
+    // Create the OpenGL buffer if it doesn't exist yet
+    if (!m_buffer)
+    {
+        GLuint buffer;
+        glCheck(glGenBuffersARB(1, &buffer));
+        m_buffer = static_cast<unsigned int>(buffer);
+
+        if (!m_buffer)
+        {
+            err() << "Failed to create vertex buffer (failed to create the OpenGL buffer)" << std::endl;
+            return false;
+        }
+    }
+
+    // Make sure that the current buffer binding will be preserved
+    GLint previous;
+    glCheck(glGetIntegerv(GL_ARRAY_BUFFER_BINDING_ARB, &previous));
+
+    // Allocate the storage, without initializing it
+    glCheck(glBindBufferARB(GL_ARRAY_BUFFER_ARB, m_buffer));
+    glCheck(glBufferDataARB(GL_ARRAY_BUFFER_ARB, sizeof(Vertex) * vertexCount, NULL, getGlUsage(m_usage)));
+    glCheck(glBindBufferARB(GL_ARRAY_BUFFER_ARB, previous));
+
+    m_size = vertexCount;
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+unsigned int VertexBuffer::getVertexCount() const
+{
+    return m_size;
+}
+
+
+////////////////////////////////////////////////////////////
+bool VertexBuffer::update(const Vertex* vertices)
+{
+    return update(vertices, m_size, 0);
+}
+
+
+////////////////////////////////////////////////////////////
+bool VertexBuffer::update(const Vertex* vertices, unsigned int vertexCount, unsigned int offset)
+{
+    // Nothing to update?
+    if (!vertices || !m_buffer || (vertexCount == 0))
+        return false;
+
+    // The updated range must lie inside the buffer, unless it replaces the whole contents
+    bool replace = (offset == 0) && (vertexCount >= m_size);
+    if (!replace && (offset + vertexCount > m_size))
+    {
+        err() << "Failed to update vertex buffer: the range [" << offset << ", " << offset + vertexCount
+              << "[ is out of the buffer bounds (" << m_size << " vertices)" << std::endl;
+        return false;
+    }
+
+    ensureGlContext();
+
+    // Make sure that the current buffer binding will be preserved
+    GLint previous;
+    glCheck(glGetIntegerv(GL_ARRAY_BUFFER_BINDING_ARB, &previous));
+
+    glCheck(glBindBufferARB(GL_ARRAY_BUFFER_ARB, m_buffer));
+    if (replace)
+    {
+        // Re-allocating the storage orphans the previous one: the driver can
+        // give us fresh memory instead of waiting for pending draws to finish
+        glCheck(glBufferDataARB(GL_ARRAY_BUFFER_ARB, sizeof(Vertex) * vertexCount, vertices, getGlUsage(m_usage)));
+        m_size = vertexCount;
+    }
+    else
+    {
+        glCheck(glBufferSubDataARB(GL_ARRAY_BUFFER_ARB, sizeof(Vertex) * offset, sizeof(Vertex) * vertexCount, vertices));
+    }
+    glCheck(glBindBufferARB(GL_ARRAY_BUFFER_ARB, previous));
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+void VertexBuffer::setPrimitiveType(PrimitiveType type)
+{
+    m_primitiveType = type;
+}
+
+
+////////////////////////////////////////////////////////////
+PrimitiveType VertexBuffer::getPrimitiveType() const
+{
+    return m_primitiveType;
+}
+
+
+////////////////////////////////////////////////////////////
+void VertexBuffer::setUsage(Usage usage)
+{
+    m_usage = usage;
+}
+
+
+////////////////////////////////////////////////////////////
+VertexBuffer::Usage VertexBuffer::getUsage() const
+{
+    return m_usage;
+}
+
+
+////////////////////////////////////////////////////////////
+unsigned int VertexBuffer::getNativeHandle() const
+{
+    return m_buffer;
+}
+
+
+////////////////////////////////////////////////////////////
+bool VertexBuffer::isAvailable()
+{
+    ensureGlContext();
+
+    // Make sure that GLEW is initialized
+    priv::ensureGlewInit();
+
+    return GLEW_ARB_vertex_buffer_object != 0;
+}
+
+
+////////////////////////////////////////////////////////////
+void VertexBuffer::draw(RenderTarget& target, RenderStates states) const
+{
+    if (m_buffer && m_size)
+        target.draw(*this, 0, m_size, states);
+}
+
+} // namespace sf